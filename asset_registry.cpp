@@ -0,0 +1,178 @@
+#include "asset_registry.h"
+
+
+
+// # AssetRegistry #
+thread_local std::vector<AssetScope> AssetRegistry::scopes;
+
+AssetRegistry::AssetRegistry(Loader loader, Unloader unloader, size_t budget) :
+	loader(loader),
+	unloader(unloader),
+	budget(budget)
+{}
+
+TextureHandle AssetRegistry::find(const std::string &filePath) {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	const auto iter = this->handles.find(filePath);
+	if (iter != this->handles.end()) { return iter->second; }
+
+	const TextureHandle handle = static_cast<TextureHandle>(this->entries.size());
+
+	this->entries.emplace_back();
+	this->entries.back().path = filePath;
+	this->handles[filePath] = handle;
+
+	return handle;
+}
+
+SDL_Texture* AssetRegistry::acquire(TextureHandle handle) {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	_asset_entry &entry = this->entries[handle];
+
+	++entry.refs[static_cast<size_t>(this->current_Scope())];
+	entry.last_used = ++this->tick;
+
+	if (!entry.texture) {
+		this->load(entry);
+		this->evict(); // can't evict the texture we've just loaded since it's referenced
+	}
+
+	return entry.texture;
+}
+
+SDL_Texture* AssetRegistry::acquireResident(TextureHandle handle) {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	_asset_entry &entry = this->entries[handle];
+	if (!entry.texture) { return nullptr; }
+
+	++entry.refs[static_cast<size_t>(this->current_Scope())];
+	entry.last_used = ++this->tick;
+
+	return entry.texture;
+}
+
+void AssetRegistry::release(TextureHandle handle) {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	_asset_entry &entry = this->entries[handle];
+
+	uint32_t &refs = entry.refs[static_cast<size_t>(this->current_Scope())];
+	if (refs) { --refs; }
+	entry.last_used = ++this->tick;
+}
+
+void AssetRegistry::prefetch(TextureHandle handle) {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	_asset_entry &entry = this->entries[handle];
+
+	entry.last_used = ++this->tick; // most recent => evicted last
+
+	if (!entry.texture) {
+		this->load(entry);
+		this->evict();
+	}
+}
+
+SDL_Texture* AssetRegistry::get(TextureHandle handle) const {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	return this->entries[handle].texture;
+}
+std::string AssetRegistry::getPath(TextureHandle handle) const {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	return this->entries[handle].path;
+}
+
+void AssetRegistry::pushScope(AssetScope scope) {
+	this->scopes.push_back(scope);
+}
+void AssetRegistry::popScope() {
+	if (!this->scopes.empty()) { this->scopes.pop_back(); }
+}
+void AssetRegistry::releaseScope(AssetScope scope) {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	for (auto &entry : this->entries) {
+		if (entry.refs[static_cast<size_t>(scope)]) {
+			entry.refs[static_cast<size_t>(scope)] = 0;
+			entry.last_used = ++this->tick;
+		}
+	}
+}
+
+void AssetRegistry::setBudget(size_t bytes) {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	this->budget = bytes;
+	this->evict();
+}
+size_t AssetRegistry::getBudget() const {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	return this->budget;
+}
+size_t AssetRegistry::getUsage() const {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	return this->usage;
+}
+
+void AssetRegistry::trim() {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	this->evict();
+}
+
+void AssetRegistry::clear() {
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	for (auto &entry : this->entries) { this->unload(entry); }
+
+	this->entries.clear();
+	this->handles.clear();
+}
+
+AssetScope AssetRegistry::current_Scope() const {
+	return this->scopes.empty() ? AssetScope::GLOBAL : this->scopes.back();
+}
+
+bool AssetRegistry::referenced(const _asset_entry &entry) const {
+	return entry.refs[0] || entry.refs[1];
+}
+
+void AssetRegistry::load(_asset_entry &entry) {
+	entry.bytes = 0;
+	entry.texture = this->loader(entry.path, entry.bytes);
+
+	this->usage += entry.bytes;
+}
+
+void AssetRegistry::unload(_asset_entry &entry) {
+	if (!entry.texture) { return; }
+
+	this->unloader(entry.texture);
+
+	this->usage -= entry.bytes;
+	entry.texture = nullptr;
+	entry.bytes = 0;
+}
+
+void AssetRegistry::evict() {
+	while (this->usage > this->budget) {
+		_asset_entry* oldest = nullptr;
+
+		for (auto &entry : this->entries) {
+			if (!entry.texture || this->referenced(entry)) { continue; }
+			if (!oldest || entry.last_used < oldest->last_used) { oldest = &entry; }
+		}
+
+		if (!oldest) { return; } // everything that's left is in use
+
+		this->unload(*oldest);
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <SDL.h> // 'SDL_Texture' type
+#include <string> // related type
+#include <vector> // related type
+#include <unordered_map> // related type
+#include <functional> // 'std::function' type (loader/unloader)
+#include <mutex> // 'std::mutex' type (simulation requests)
+#include <cstdint> // fixed-size types (handles)
+
+
+
+typedef uint32_t TextureHandle; // index of registry entry, stays valid until 'AssetRegistry::clear()'
+
+// # AssetScope #
+// - References made in a scope can be dropped all at once
+enum class AssetScope : uint8_t {
+	GLOBAL, // player, GUI, inventory and everything else that lives across levels
+	LEVEL // released upon level change
+};
+
+
+
+// # _asset_entry #
+// - NOT INTENDED FOR EXTERNAL USE!
+struct _asset_entry {
+	std::string path;
+
+	SDL_Texture* texture = nullptr; // nullptr => not loaded or evicted
+	size_t bytes = 0; // estimated VRAM usage
+
+	uint32_t refs[2] = { 0, 0 }; // references per scope
+	uint64_t last_used = 0; // tick of the last acquire/release/prefetch
+};
+
+
+
+// # AssetRegistry #
+// - Part of 'Graphics' module
+// - Keeps track of loaded textures, hands out integer handles and counts references per scope
+// - Tracks estimated VRAM usage, textures without references are kept as a cache and evicted
+// in least-recently-used order once usage exceeds the budget
+// - Referenced textures are never evicted, anything that stores 'SDL_Texture*' should hold a reference
+// (which 'Graphics::getTexture()' does automatically in the current scope)
+// - Loading and destruction of textures are done by 'Graphics' through given functions,
+// loader also reports texture size in bytes
+// - Thread-safe, simulation acquires resident textures while main thread streams levels,
+// scope stack is per thread, so scopes pushed by one thread don't affect references made by another
+class AssetRegistry {
+public:
+	using Loader = std::function<SDL_Texture*(const std::string&, size_t&)>;
+	using Unloader = std::function<void(SDL_Texture*)>;
+
+	AssetRegistry(Loader loader, Unloader unloader, size_t budget = DEFAULT_BUDGET);
+
+	TextureHandle find(const std::string &filePath); // registers path if necessary, never loads
+	SDL_Texture* acquire(TextureHandle handle); // loads texture if necessary and adds a reference in current scope
+	SDL_Texture* acquireResident(TextureHandle handle); // same as above, but never loads, returns nullptr if texture isn't loaded
+	void release(TextureHandle handle); // removes a reference of current scope
+	void prefetch(TextureHandle handle); // loads texture without adding references
+
+	SDL_Texture* get(TextureHandle handle) const; // returns nullptr if texture isn't loaded
+	std::string getPath(TextureHandle handle) const; // copy, entries may move once another thread registers a path
+
+	void pushScope(AssetScope scope); // following acquires of the current thread reference textures in <scope>
+	void popScope();
+	void releaseScope(AssetScope scope); // drops all references made in <scope>, textures stay cached until evicted
+
+	void setBudget(size_t bytes);
+	size_t getBudget() const;
+	size_t getUsage() const; // estimated VRAM of all loaded textures
+
+	void trim(); // evicts unreferenced textures until usage fits the budget
+	void clear(); // unloads everything, all handles become invalid
+
+	static const size_t DEFAULT_BUDGET = 256 * 1024 * 1024; // in bytes
+
+private:
+	AssetScope current_Scope() const;
+	bool referenced(const _asset_entry &entry) const;
+	void load(_asset_entry &entry);
+	void unload(_asset_entry &entry);
+	void evict(); // 'trim()' without locking
+
+	Loader loader;
+	Unloader unloader;
+
+	std::vector<_asset_entry> entries;
+	std::unordered_map<std::string, TextureHandle> handles;
+
+	static thread_local std::vector<AssetScope> scopes; // empty => GLOBAL
+
+	mutable std::mutex mutex; // guards everything above except 'scopes'
+
+	uint64_t tick = 0;
+	size_t usage = 0;
+	size_t budget;
+};
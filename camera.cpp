@@ -14,15 +14,10 @@ Camera::Camera(const Vector2d &position) :
 	this->standard_FOV = Vector2(rendering::RENDERING_WIDTH, rendering::RENDERING_HEIGHT);
 	this->backbuffer_size = (this->standard_FOV + Vector2(this->MARGIN, this->MARGIN)) * 2;
 
-	this->backbuffer = SDL_CreateTexture(
-		Graphics::ACCESS->getRenderer(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
-		this->backbuffer_size.x, this->backbuffer_size.y
-	);
-
-	SDL_SetTextureBlendMode(this->backbuffer, SDL_BLENDMODE_BLEND); // necessary for proper blending of of transparent parts
+	this->backbuffer = Graphics::ACCESS->createTarget(this->backbuffer_size);
 }
 Camera::~Camera() {
-	SDL_DestroyTexture(this->backbuffer);
+	Graphics::ACCESS->destroyTarget(this->backbuffer);
 }
 
 Rectangle Camera::getFOV_Rect() const {
@@ -32,35 +27,42 @@ Vector2 Camera::getFOV_size() const {
 	return (this->standard_FOV * this->zoom);
 }
 
+bool Camera::inView(const Rectangle &area) const {
+	// Margin is included since it becomes visible during tilt/screen shake
+	const Rectangle view(this->position.toVector2(), (this->standard_FOV + Vector2(this->MARGIN, this->MARGIN) * 2) * this->zoom, true);
+
+	return view.overlapsWithRect(area);
+}
+
 void Camera::textureToCamera(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect) {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), this->backbuffer); // target backbuffer for rendering
+	const SDL_Rect worldDestRect = { destRect->x + this->draw_offset.x, destRect->y + this->draw_offset.y, destRect->w, destRect->h };
 
-	const Vector2 cameraCornerPos = this->position.toVector2() - (this->backbuffer_size / 2 - Vector2(this->MARGIN, this->MARGIN));
-	// position of top-left corner of the camera with standard zoom
+	if (!this->capture_target && !this->inView(Rectangle(worldDestRect.x, worldDestRect.y, worldDestRect.w, worldDestRect.h))) {
+		Graphics::ACCESS->batch->countCulled();
+		return;
+	}
 
-	SDL_Rect backbufferDestRect = {
-		destRect->x + this->MARGIN - cameraCornerPos.x, destRect->y + this->MARGIN - cameraCornerPos.y,
-		destRect->w, destRect->h
-	};
+	const SDL_Rect targetDestRect = this->to_target(&worldDestRect);
 
-	SDL_RenderCopy(Graphics::ACCESS->getRenderer(), texture, sourceRect, &backbufferDestRect);
+	if (this->capture_target) { Graphics::ACCESS->batch->add(this->capture_target, texture, sourceRect, &targetDestRect); } // capture is immediate
+	else { Graphics::ACCESS->queue->record(this->backbuffer, texture, sourceRect, &targetDestRect); }
 }
 void Camera::textureToCameraEx(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip) {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), this->backbuffer); // target backbuffer for rendering
+	const SDL_Rect worldDestRect = { destRect->x + this->draw_offset.x, destRect->y + this->draw_offset.y, destRect->w, destRect->h };
 
-	const Vector2 cameraCornerPos = this->position.toVector2() - (this->backbuffer_size / 2 - Vector2(this->MARGIN, this->MARGIN));
-	// position of top-left corner of the camera with standard zoom
+	if (!this->capture_target && !this->inView(Rectangle(worldDestRect.x, worldDestRect.y, worldDestRect.w, worldDestRect.h))) {
+		Graphics::ACCESS->batch->countCulled();
+		return;
+	}
 
-	SDL_Rect backbufferDestRect = {
-		destRect->x + this->MARGIN - cameraCornerPos.x, destRect->y + this->MARGIN - cameraCornerPos.y,
-		destRect->w, destRect->h
-	};
+	const SDL_Rect targetDestRect = this->to_target(&worldDestRect);
 
-	SDL_RenderCopyEx(Graphics::ACCESS->getRenderer(), texture, sourceRect, &backbufferDestRect, angle, NULL, flip);
+	if (this->capture_target) { Graphics::ACCESS->batch->add(this->capture_target, texture, sourceRect, &targetDestRect, angle, flip); } // capture is immediate
+	else { Graphics::ACCESS->queue->record(this->backbuffer, texture, sourceRect, &targetDestRect, angle, flip); }
 }
 
 void Camera::cameraToRenderer() {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), NULL); // give target back to the renderer
+	Graphics::ACCESS->queue->submit(); // backbuffer must be complete
 
 	const Vector2 sourceRectCenter = this->backbuffer_size / 2;
 	const Vector2 sourceRectDimensions = this->standard_FOV * zoom + Vector2(this->MARGIN, this->MARGIN) * 2 * zoom;
@@ -74,7 +76,35 @@ void Camera::cameraToRenderer() {
 	Graphics::ACCESS->copyTextureToRendererEx(this->backbuffer, &sourceRect, &destRect, this->angle);
 }
 void Camera::cameraClear() {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), this->backbuffer); // target backbuffer for rendering
+	Graphics::ACCESS->clearTarget(this->backbuffer); // target backbuffer for rendering
+}
 
-	SDL_RenderClear(Graphics::ACCESS->getRenderer());
+void Camera::beginCapture(SDL_Texture* target, const Vector2 &corner) {
+	this->capture_target = target;
+	this->capture_corner = corner;
+
+	Graphics::ACCESS->clearTarget(target);
+}
+void Camera::endCapture() {
+	Graphics::ACCESS->batch->flush(this->capture_target); // captured texture is ready to use right after capture
+
+	this->capture_target = nullptr;
+}
+
+void Camera::setDrawOffset(const Vector2 &offset) {
+	this->draw_offset = offset;
+}
+
+SDL_Rect Camera::to_target(const SDL_Rect* destRect) const {
+	if (this->capture_target) {
+		return { destRect->x - this->capture_corner.x, destRect->y - this->capture_corner.y, destRect->w, destRect->h };
+	}
+
+	const Vector2 cameraCornerPos = this->position.toVector2() - (this->backbuffer_size / 2 - Vector2(this->MARGIN, this->MARGIN));
+	// position of top-left corner of the camera with standard zoom
+
+	return {
+		destRect->x + this->MARGIN - cameraCornerPos.x, destRect->y + this->MARGIN - cameraCornerPos.y,
+		destRect->w, destRect->h
+	};
 }
\ No newline at end of file
@@ -20,14 +20,27 @@ public:
 	Rectangle getFOV_Rect() const; // returns rectangle with current Field Of View
 	Vector2 getFOV_size() const; // returns size of a current Field Of View
 
+	bool inView(const Rectangle &area) const; // returns whether area can be visible, accounts for margin and zoom
+
 	void textureToCamera(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect);
 		// copies sourceRect from given texture to destinationRect on renderer
+		// textures outside of view are culled (unless capture is in progress)
+		// drawing is recorded into 'RenderQueue' with its current layer, capture draws immediately
 	void textureToCameraEx(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip);
 		// same as above but allows rotation and flips
 
 	void cameraToRenderer();
 	void cameraClear();
 
+	void beginCapture(SDL_Texture* target, const Vector2 &corner);
+		// clears <target> and redirects all drawing to it until 'endCapture()', <corner> is the world position of target top-left corner
+		// used to pre-render static parts of the level, target should be created with 'Graphics::createTarget()'
+	void endCapture();
+
+	void setDrawOffset(const Vector2 &offset);
+		// shifts all following drawing by <offset> (in world coordinates) until it's set back to zero
+		// allows drawing a single object at several places without moving it
+
 	Vector2d position;
 	double zoom; // max zoom-out is 2
 	double angle;
@@ -39,4 +52,11 @@ private:
 		// a bit bigger than view field to account for small rotation/transitions during screen shake
 	Vector2 backbuffer_size; // backbuffer size (not including margin)
 	int MARGIN = 200; // said margin
+
+	SDL_Texture* capture_target = nullptr; // not owned, nullptr => drawing goes to backbuffer
+	Vector2 capture_corner;
+
+	Vector2 draw_offset;
+
+	SDL_Rect to_target(const SDL_Rect* destRect) const; // converts world rect to rect on current rendering target
 };
\ No newline at end of file
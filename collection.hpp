@@ -1,117 +1,232 @@
 #pragma once
 
-#include <unordered_map> /// ? change to set ?
-#include <memory> // 'unique_ptr' type
+#include <vector> // related type (dense storage, slots)
+#include <memory> // 'unique_ptr', 'shared_ptr' types
 #include <utility> // 'std::forward' type (forwarding argument packet to 'std::make_unique()')
+#include <algorithm> // 'std::min()' (iterator positions)
+#include <cstdint> // fixed-size types (slots)
 #include <initializer_list> /// TEMP
 
 
 
-// # _map_ptrkey_iterator #
+// # _collection_slot #
 // - NOT INTENDED FOR EXTERNAL USE!
-// - Allows convenient iteration over map keys
-// - Intended to be used for map with pointer ::key_type
-template<typename Iter>
-class _map_ptrkey_iterator : public Iter
-{
-public:
-	_map_ptrkey_iterator() : Iter() {}
-	_map_ptrkey_iterator(Iter iter) : Iter(iter) {}
-	auto* operator->()
-	{
-		return Iter::operator->()->first;
-	}
-	auto& operator*()
-	{
-		return *(Iter::operator*().first);
-	}
+// - Indirection between handles and dense storage
+struct _collection_slot {
+	uint32_t index; // position in dense storage if slot is occupied, next free slot otherwise
+	uint32_t generation; // incremented upon erasion, handles with older generation are stale
 };
 
 
 
 // # Collection<> #
-// - Polymorphic container
-// - Can be iterated through
-// - Provides a robust 'handle' when inserting new elements
-// - Allows erasion of elements through handles and iteration
+// - Polymorphic container, implemented as a slot map
+// - Elements are kept in dense storage and iterated in a deterministic order (order of insertion, erased element
+// is replaced by the last one)
+// - Provides a robust 'handle' when inserting new elements, handles detect erased elements and collection destruction
+// - Insertion and erasion are O(1), elements never move in memory
+// - Allows erasion of elements through handles and iteration, erasion during iteration never invalidates iterators,
+// although erasion of other elements through handles can make the iteration skip the element that took their place
 template<class Object>
 class Collection {
-	using map_t = std::unordered_map< Object*, std::unique_ptr<Object> >;
+	static const uint32_t NO_SLOT = UINT32_MAX;
+
 public:
+	Collection() : self(std::make_shared<Collection<Object>*>(this)) {}
+
+	~Collection() {
+		if (this->self) { *this->self = nullptr; } // all handles become stale
+	}
+
+	Collection(Collection<Object> &&other) :
+		objects(std::move(other.objects)),
+		owners(std::move(other.owners)),
+		slots(std::move(other.slots)),
+		free_slot(other.free_slot),
+		self(std::move(other.self))
+	{
+		*this->self = this; // handles follow the elements
+		other.reset();
+	}
+
+	Collection<Object>& operator=(Collection<Object> &&other) {
+		if (this == &other) { return *this; }
+
+		*this->self = nullptr; // handles to current elements become stale
+
+		this->objects = std::move(other.objects);
+		this->owners = std::move(other.owners);
+		this->slots = std::move(other.slots);
+		this->free_slot = other.free_slot;
+		this->self = std::move(other.self);
+
+		*this->self = this;
+		other.reset();
+
+		return *this;
+	}
+
+	Collection(const Collection<Object> &other) = delete;
+	Collection<Object>& operator=(const Collection<Object> &other) = delete;
 
 
 	// # Collection<>::Handle #
 	// - Allows access and const-access to the element
 	// - Allows safe erasion of the element
-	// - Get invalidated if parent collection is deleted
+	// - Becomes stale when element is erased or parent collection is deleted, which can be checked with 'valid()'
 	class handle {
 	public:
-		handle() : collection(nullptr), node_key(nullptr) {}
+		handle() : slot(NO_SLOT), generation(0) {}
 
-		handle(Collection<Object>* collection, Object* node) :
+		handle(const std::shared_ptr<Collection<Object>*> &collection, uint32_t slot, uint32_t generation) :
 			collection(collection),
-			node_key(node)
+			slot(slot),
+			generation(generation)
 		{}
 
-		Object& get() {
-			return *this->node_key;
+		bool valid() const {
+			return this->collection && *this->collection && (*this->collection)->occupied(this->slot, this->generation);
+		}
+
+		Object* ptr() { // nullptr if handle is stale
+			return this->valid() ? (*this->collection)->objects[(*this->collection)->slots[this->slot].index].get() : nullptr;
+		}
+
+		Object& get() { // handle should be valid
+			return *this->ptr();
 		}
 		const Object& cget() {
-			return *this->node_key;
+			return *this->ptr();
 		}
 
 		bool erase() { // returns if node was erased, safe to call on already erased elements
-			if (this->collection && this->node_key) {
-				this->collection->storage.erase(this->node_key);
-				this->node_key = nullptr;
+			if (this->valid()) {
+				Collection<Object> &parent = **this->collection;
+				parent.erase_at(parent.slots[this->slot].index);
+				this->collection.reset();
 				return true;
 			}
 			return false;
 		}
 
 	private:
-		Collection<Object>* collection;
-		Object* node_key; // nullptr when handle is invalid
+		std::shared_ptr<Collection<Object>*> collection; // points to nullptr once collection is deleted
+		uint32_t slot;
+		uint32_t generation;
 	};
 
 
-	// Iteration
-	using iterator = _map_ptrkey_iterator<typename map_t::iterator>;
-	using const_iterator = _map_ptrkey_iterator<typename map_t::const_iterator>;
+	// # Collection<>::Iterator #
+	// - Walks dense storage by index, so insertion and erasion during iteration are safe
+	template<class Parent, class Value>
+	class basic_iterator {
+	public:
+		basic_iterator(Parent* collection, size_t index) : collection(collection), index(index) {}
+
+		Value& operator*() const { return *this->collection->objects[this->index]; }
+		Value* operator->() const { return this->collection->objects[this->index].get(); }
+
+		basic_iterator& operator++() { ++this->index; return *this; }
+		basic_iterator operator++(int) { basic_iterator copy = *this; ++this->index; return copy; }
+
+		bool operator==(const basic_iterator &other) const { return this->position() == other.position(); }
+		bool operator!=(const basic_iterator &other) const { return this->position() != other.position(); }
 
-	iterator begin() { return this->storage.begin(); }
-	iterator end() { return this->storage.end(); }
-	const_iterator begin() const { return this->storage.begin(); }
-	const_iterator end() const { return this->storage.end(); }
-	const_iterator cbegin() const { return this->storage.cbegin(); }
-	const_iterator cend() const { return this->storage.cend(); }
+	private:
+		friend class Collection<Object>;
+
+		size_t position() const { return std::min(this->index, this->collection->objects.size()); } // end is clamped to current size
+
+		Parent* collection;
+		size_t index;
+	};
+
+	using iterator = basic_iterator<Collection<Object>, Object>;
+	using const_iterator = basic_iterator<const Collection<Object>, const Object>;
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, SIZE_MAX); }
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, SIZE_MAX); }
+	const_iterator cbegin() const { return const_iterator(this, 0); }
+	const_iterator cend() const { return const_iterator(this, SIZE_MAX); }
 
 	// Methods
 	template<class... Args>
 	handle insert(Args&&... args) {
-		std::unique_ptr<Object> node_value = std::make_unique<Object>(std::forward<Args>(args)...);
-		Object* node_key = node_value.get();
-
-		this->storage[node_key] = std::move(node_value);
-
-		return handle(this, node_key);
+		return this->insert_node(std::make_unique<Object>(std::forward<Args>(args)...));
 	}
 
 	template<class DerivedObject>
 	handle insert(std::unique_ptr<DerivedObject> &&node_value) {
-		Object* node_key = node_value.get();
+		return this->insert_node(std::unique_ptr<Object>(std::move(node_value)));
+	}
+
+	iterator erase(iterator iter) { // returns iterator to the element that took place of the erased one
+		this->erase_at(iter.index);
+		return iter;
+	}
+
+	size_t size() const { return this->objects.size(); }
+	bool empty() const { return this->objects.empty(); }
+
+private:
+	handle insert_node(std::unique_ptr<Object> &&node_value) {
+		uint32_t slot = this->free_slot;
+
+		if (slot != NO_SLOT) {
+			this->free_slot = this->slots[slot].index;
+		}
+		else {
+			slot = static_cast<uint32_t>(this->slots.size());
+			this->slots.push_back({ 0, 0 });
+		}
 
-		this->storage[node_key] = std::move(node_value);
+		this->slots[slot].index = static_cast<uint32_t>(this->objects.size());
+		this->objects.push_back(std::move(node_value));
+		this->owners.push_back(slot);
 
-		return handle(this, node_key);
+		return handle(this->self, slot, this->slots[slot].generation);
 	}
 
-	size_t erase(iterator iter) {
-		return this->storage.erase(&(*iter)); // probably not the best way to do it
+	void erase_at(size_t index) {
+		std::unique_ptr<Object> erased = std::move(this->objects[index]); // destroyed after storage is consistent again
+		const uint32_t slot = this->owners[index];
+
+		// Move last element into the gap
+		const size_t last = this->objects.size() - 1;
+		if (index != last) {
+			this->objects[index] = std::move(this->objects[last]);
+			this->owners[index] = this->owners[last];
+			this->slots[this->owners[index]].index = static_cast<uint32_t>(index);
+		}
+		this->objects.pop_back();
+		this->owners.pop_back();
+
+		// Free the slot
+		++this->slots[slot].generation;
+		this->slots[slot].index = this->free_slot;
+		this->free_slot = slot;
 	}
 
-private:
-	map_t storage;
+	bool occupied(uint32_t slot, uint32_t generation) const {
+		return slot < this->slots.size() && this->slots[slot].generation == generation;
+	}
+
+	void reset() { // leaves moved-from collection empty and usable
+		this->objects.clear();
+		this->owners.clear();
+		this->slots.clear();
+		this->free_slot = NO_SLOT;
+		this->self = std::make_shared<Collection<Object>*>(this);
+	}
+
+	std::vector<std::unique_ptr<Object>> objects; // dense storage
+	std::vector<uint32_t> owners; // slot of each element in dense storage
+	std::vector<_collection_slot> slots;
+	uint32_t free_slot = NO_SLOT; // head of the free list
+
+	std::shared_ptr<Collection<Object>*> self; // shared with handles
 };
 
 
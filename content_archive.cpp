@@ -0,0 +1,214 @@
+#include "content_archive.h"
+
+#include <fstream> // writing archive
+#include <filesystem> // listing content folder, path normalization
+#include <vector> // related type
+#include <cstring> // 'std::memcpy()'
+#include <algorithm> // 'std::replace()'
+
+
+
+// Layout (all values are little-endian):
+// - header: magic, format version, entry count
+// - index: (string path, uint64 offset, uint64 size) for each entry
+// - data: files one after another, each aligned to 16 bytes
+// Strings are stored as uint32 length followed by characters
+// Offsets are counted from the start of the archive
+
+namespace {
+	const uint32_t ARCHIVE_MAGIC = 0x4B504D48; // "HMPK"
+	const uint32_t ARCHIVE_VERSION = 1; // increment upon any change to layout
+	const size_t DATA_ALIGNMENT = 16;
+
+	// "content\\a/../b.json" => "content/b.json"
+	std::string normalize_path(const std::string &filePath) {
+		std::string path = filePath;
+		std::replace(path.begin(), path.end(), '\\', '/');
+
+		return std::filesystem::path(path).lexically_normal().generic_string();
+	}
+
+	void write_u32(std::string &buffer, uint32_t value) {
+		for (int i = 0; i < 4; ++i) { buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF)); }
+	}
+	void write_u64(std::string &buffer, uint64_t value) {
+		for (int i = 0; i < 8; ++i) { buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF)); }
+	}
+
+	// # _archive_reader #
+	// - NOT INTENDED FOR EXTERNAL USE!
+	// - Bounds-checked sequential reading, 'good' becomes false upon reading past the end
+	struct _archive_reader {
+		const unsigned char* bytes;
+		size_t length;
+		size_t pos = 0;
+		bool good = true;
+
+		bool available(size_t count) {
+			if (this->good && count <= this->length - this->pos) { return true; }
+			this->good = false;
+			return false;
+		}
+
+		uint64_t uint(int byteCount) {
+			if (!this->available(byteCount)) { return 0; }
+			uint64_t value = 0;
+			for (int i = 0; i < byteCount; ++i) { value |= static_cast<uint64_t>(this->bytes[this->pos + i]) << (8 * i); }
+			this->pos += byteCount;
+			return value;
+		}
+
+		std::string str() {
+			const size_t size = static_cast<size_t>(this->uint(4));
+			if (!this->available(size)) { return std::string(); }
+			std::string value(reinterpret_cast<const char*>(this->bytes + this->pos), size);
+			this->pos += size;
+			return value;
+		}
+	};
+}
+
+
+
+// # ContentArchive #
+const ContentArchive* ContentArchive::READ;
+
+const std::string ContentArchive::DEFAULT_PATH = "content.pak";
+
+ContentArchive::ContentArchive(const std::string &archivePath) :
+	file(archivePath)
+{
+	ContentArchive::READ = this;
+
+	if (!this->file.is_open()) { return; } // no archive => content is read from disk
+
+	_archive_reader reader{ reinterpret_cast<const unsigned char*>(this->file.data()), this->file.size() };
+
+	if (reader.uint(4) != ARCHIVE_MAGIC || reader.uint(4) != ARCHIVE_VERSION) {
+		this->file = MappedFile(); // malformed or outdated archive is ignored
+		return;
+	}
+
+	const size_t entryCount = static_cast<size_t>(reader.uint(4));
+	for (size_t i = 0; i < entryCount && reader.good; ++i) {
+		std::string path = reader.str();
+		_archive_entry entry;
+		entry.offset = reader.uint(8);
+		entry.size = reader.uint(8);
+
+		if (entry.offset > this->file.size() || entry.size > this->file.size() - entry.offset) { reader.good = false; }
+		if (reader.good) { this->index[std::move(path)] = entry; }
+	}
+
+	if (!reader.good) {
+		this->index.clear();
+		this->file = MappedFile();
+	}
+}
+
+ContentArchive::~ContentArchive() {
+	if (ContentArchive::READ == this) { ContentArchive::READ = nullptr; }
+}
+
+bool ContentArchive::is_open() const {
+	return this->file.is_open();
+}
+
+bool ContentArchive::find(const std::string &filePath, const char* &data, size_t &size) const {
+	if (this->index.empty()) { return false; }
+
+	const auto iter = this->index.find(normalize_path(filePath));
+	if (iter == this->index.end()) { return false; }
+
+	data = this->file.data() + iter->second.offset;
+	size = static_cast<size_t>(iter->second.size);
+	return true;
+}
+
+bool ContentArchive::pack(const std::string &folder, const std::string &archivePath) {
+	std::error_code error;
+
+	// Collect files
+	std::vector<std::string> paths;
+	for (const auto &entry : std::filesystem::recursive_directory_iterator(folder, error)) {
+		if (entry.is_regular_file()) { paths.push_back(normalize_path(entry.path().generic_string())); }
+	}
+	if (error) { return false; }
+
+	std::sort(paths.begin(), paths.end()); // same content => same archive
+
+	// Header and index
+	std::string header;
+	write_u32(header, ARCHIVE_MAGIC);
+	write_u32(header, ARCHIVE_VERSION);
+	write_u32(header, static_cast<uint32_t>(paths.size()));
+
+	size_t indexSize = 0;
+	for (const auto &path : paths) { indexSize += 4 + path.size() + 8 + 8; }
+
+	const auto align = [](uint64_t offset) { return (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT; };
+
+	uint64_t offset = align(header.size() + indexSize);
+	std::vector<uint64_t> sizes;
+	for (const auto &path : paths) {
+		const uint64_t size = std::filesystem::file_size(path, error);
+		if (error) { return false; }
+
+		write_u32(header, static_cast<uint32_t>(path.size()));
+		header += path;
+		write_u64(header, offset);
+		write_u64(header, size);
+
+		sizes.push_back(size);
+		offset = align(offset + size);
+	}
+
+	// Data (write + rename, so a partially written archive is never read)
+	const std::string tempPath = archivePath + ".tmp";
+	{
+		std::ofstream archive(tempPath, std::ios::binary);
+		archive.write(header.data(), header.size());
+
+		uint64_t written = header.size();
+		for (size_t i = 0; i < paths.size(); ++i) {
+			const std::string padding(static_cast<size_t>(align(written) - written), '\0');
+			archive.write(padding.data(), padding.size());
+			written += padding.size();
+
+			const MappedFile source(paths[i]);
+			if (!source.is_open() || source.size() != sizes[i]) { return false; } // file changed during packing
+			if (source.size()) { archive.write(source.data(), source.size()); }
+			written += source.size();
+		}
+
+		if (!archive) { return false; }
+	}
+
+	std::filesystem::rename(tempPath, archivePath, error);
+
+	return !error;
+}
+
+
+
+// # ContentFile #
+ContentFile::ContentFile(const std::string &filePath) {
+	if (ContentArchive::READ && ContentArchive::READ->find(filePath, this->view_data, this->view_size)) {
+		this->from_archive = true;
+		return;
+	}
+
+	this->file = MappedFile(filePath);
+}
+
+bool ContentFile::is_open() const {
+	return this->from_archive || this->file.is_open();
+}
+
+const char* ContentFile::data() const {
+	if (this->from_archive) { return this->view_size ? this->view_data : nullptr; }
+	return this->file.data();
+}
+size_t ContentFile::size() const {
+	return this->from_archive ? this->view_size : this->file.size();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string> // related type
+#include <unordered_map> // related type
+#include <cstdint> // fixed-size types (archive format)
+
+#include "mapped_file.h" // 'MappedFile' class
+
+
+
+// # _archive_entry #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Location of a single file inside of the archive
+struct _archive_entry {
+	uint64_t offset;
+	uint64_t size;
+};
+
+
+
+// # ContentArchive #
+// - Can be accessed wherever #include'ed through static 'READ' field
+// - Single file that holds all content (levels, tilesets, textures) and an index of it
+// - Archive is memory-mapped upon construction, files are read directly from the mapping
+// - If archive is absent all content is read from 'content/' folder as usual
+// - Paths are the same as on disk aka "content/textures/gui/font.png"
+// - Read-only after construction, so it's safe to read from several threads
+class ContentArchive {
+public:
+	ContentArchive(const std::string &archivePath = DEFAULT_PATH); // absent archive is not an error
+
+	~ContentArchive();
+
+	static const ContentArchive* READ; // used for aka 'global' access
+
+	bool is_open() const;
+
+	bool find(const std::string &filePath, const char* &data, size_t &size) const; // returns false if file is not in the archive
+
+	static bool pack(const std::string &folder, const std::string &archivePath = DEFAULT_PATH);
+		// packs all files inside of <folder> (recursively) into a new archive, returns false on failure
+
+	static const std::string DEFAULT_PATH;
+
+private:
+	MappedFile file;
+
+	std::unordered_map<std::string, _archive_entry> index;
+};
+
+
+
+// # ContentFile #
+// - Read-only view of a single content file
+// - Looks into the archive first, falls back to mapping the file from disk
+// - Data is valid while the object is alive
+class ContentFile {
+public:
+	ContentFile(const std::string &filePath);
+
+	bool is_open() const;
+
+	const char* data() const; // returns nullptr for empty/missing files
+	size_t size() const;
+
+private:
+	MappedFile file; // used only when file is not in the archive
+
+	const char* view_data = nullptr;
+	size_t view_size = 0;
+	bool from_archive = false;
+};
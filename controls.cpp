@@ -3,8 +3,8 @@
 
 
 // # Controls #
-const Controls* Controls::READ;
-Controls* Controls::ACCESS;
+thread_local const Controls* Controls::READ;
+thread_local Controls* Controls::ACCESS;
 
 Controls::Controls() {
 	this->READ = this;
@@ -8,8 +8,8 @@ class Controls {
 public:
 	Controls();
 
-	static const Controls* READ;
-	static Controls* ACCESS;
+	static thread_local const Controls* READ;
+	static thread_local Controls* ACCESS;
 
 	SDL_Scancode LEFT;
 	SDL_Scancode RIGHT;
@@ -0,0 +1,46 @@
+#include "effect_buffer.h"
+
+
+
+namespace {
+thread_local EffectBuffer* boundBuffer = nullptr; // buffer of the task running on this thread
+}
+
+
+
+// # EffectBuffer::Binding #
+EffectBuffer::Binding::Binding(EffectBuffer* buffer) :
+	previous(boundBuffer)
+{
+	boundBuffer = buffer;
+}
+
+EffectBuffer::Binding::~Binding() {
+	boundBuffer = this->previous;
+}
+
+
+
+// # EffectBuffer #
+
+void EffectBuffer::record(std::function<void()> &&effect) {
+	this->effects.push_back(std::move(effect));
+}
+void EffectBuffer::apply() {
+	// Effects can't record new effects here (nothing is bound on the applying thread), so the loop is stable
+	for (auto &effect : this->effects) { effect(); }
+
+	this->effects.clear();
+}
+
+size_t EffectBuffer::size() const {
+	return this->effects.size();
+}
+
+void EffectBuffer::defer(std::function<void()> &&effect) {
+	if (boundBuffer) { boundBuffer->effects.push_back(std::move(effect)); }
+	else { effect(); }
+}
+bool EffectBuffer::deferring() {
+	return boundBuffer != nullptr;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector> // related type
+#include <functional> // 'std::function' type (effects)
+
+
+
+// # EffectBuffer #
+// - Collects effects that entity updates have on other entities and global state (damage, impulses, pickups, emits)
+// - While a buffer is bound to the thread, 'EffectBuffer::defer()' records effects into it,
+// when no buffer is bound effects are applied right away
+// - Parallel entity updates bind one buffer per task and apply buffers in order of tasks once all tasks finish,
+// so the result doesn't depend on the number of threads or their scheduling
+// - Buffers are bound through 'EffectBuffer::Binding', bindings nest (a job can run inside of 'wait()' of another one)
+class EffectBuffer {
+public:
+	// # EffectBuffer::Binding #
+	// - Binds buffer to current thread for the lifetime of the object, previous binding is restored upon destruction
+	// - nullptr buffer => effects are applied right away
+	class Binding {
+	public:
+		Binding(EffectBuffer* buffer);
+
+		~Binding();
+
+		Binding(const Binding &other) = delete;
+		Binding& operator=(const Binding &other) = delete;
+
+	private:
+		EffectBuffer* previous;
+	};
+
+	EffectBuffer() = default;
+
+	void record(std::function<void()> &&effect); // records <effect> into this buffer regardless of binding
+	void apply(); // applies recorded effects in order of recording and clears the buffer
+
+	size_t size() const;
+
+	static void defer(std::function<void()> &&effect); // records <effect> into bound buffer or applies it if there is none
+	static bool deferring(); // returns whether current thread has a bound buffer
+
+private:
+	std::vector<std::function<void()>> effects;
+};
@@ -1,5 +1,7 @@
 #include "emit.h"
 
+#include "effect_buffer.h" // deferring emits made during parallel entity updates
+
 
 
 // # _emit_properties #
@@ -11,8 +13,8 @@ _emit_properties::_emit_properties(int lifetime) :
 
 
 // # EmitStorage #
-const EmitStorage* EmitStorage::READ;
-EmitStorage* EmitStorage::ACCESS;
+thread_local const EmitStorage* EmitStorage::READ;
+thread_local EmitStorage* EmitStorage::ACCESS;
 
 EmitStorage::EmitStorage() :
 	changed_held(false)
@@ -65,6 +67,11 @@ bool EmitStorage::changed() const {
 }
 
 void EmitStorage::emit_add(const std::string &emit, int lifetime) {
+	if (EffectBuffer::deferring()) {
+		EffectBuffer::defer([this, emit, lifetime]() { this->emit_add(emit, lifetime); });
+		return;
+	}
+
 	this->emit_queue[emit] = _emit_properties(lifetime);
 
 	this->changed_held = true;
@@ -23,7 +23,7 @@ struct _emit_properties {
 
 
 // # EmitStorage #
-// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields
+// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields (per instance, see 'InstanceContext')
 // - Emits with negative lifetime never expire
 // - Emits with 0 lifetime live exactly 1 frame
 // - Umits with positive lifetime expire after a given time in ms
@@ -31,8 +31,8 @@ class EmitStorage {
 public:
 	EmitStorage();
 
-	static const EmitStorage* READ; // used for aka 'global' access
-	static EmitStorage* ACCESS;
+	static thread_local const EmitStorage* READ; // used for aka 'global' access
+	static thread_local EmitStorage* ACCESS;
 
 	void update(Milliseconds elapsedTime); // updates the storage, removes single-frame emits
 
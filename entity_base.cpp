@@ -7,13 +7,13 @@ Entity::Entity(const Vector2d &position) :
 	sprite(nullptr),
 	solid(nullptr),
 	health(nullptr),
-	position(position)
+	position(position),
+	previous_position(position)
 {}
 
 void Entity::update(Milliseconds elapsedTime) {
 	if (this->enabled) {
 		if (this->sprite) { this->sprite->update(elapsedTime); }
-		if (this->solid) { this->solid->update(elapsedTime); }
 		if (this->health) { this->health->update(elapsedTime); }	
 	}
 }
@@ -29,6 +29,7 @@ public:
 
 
 	Vector2d position; // position in a level
+	Vector2d previous_position; // position before the last simulation step, used to interpolate drawing
 
 	std::unique_ptr<Sprite> sprite;
 	std::unique_ptr<SolidRectangle> solid;
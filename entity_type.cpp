@@ -5,6 +5,7 @@
 #include "item_unique.h" // item classes (to assign loot to entities)
 #include "controls.h" // access to control keys
 #include "globalconsts.hpp" // physical consts
+#include "effect_buffer.h" // deferring effects on other entities (parallel entity updates)
 
 
 /* ### PRIMITIVE TYPES ### */
@@ -45,15 +46,6 @@ void entity_primitive_types::Creature::_init_sprite(const std::string &imageFile
 		);
 	this->_sprite = dynamic_cast<ControllableSprite*>(this->sprite.get());
 }
-void entity_primitive_types::Creature::_init_solid(const Vector2 &hitboxSize, const std::initializer_list<SolidFlags> &flags, double mass, double friction) {
-	this->solid = std::make_unique<SolidRectangle>(
-		this->position,
-		hitboxSize,
-		flags,
-		mass,
-		friction
-		);
-}
 void entity_primitive_types::Creature::_init_health(Fraction fraction, uint maxHp, sint regen, sint physRes, sint magicRes, sint dotRes) {
 	this->health = std::make_unique<Health>(fraction, maxHp, regen, physRes, magicRes, dotRes);
 }
@@ -123,8 +115,11 @@ void entity_types::ItemEntity::activate() {
 	// No default effects
 }
 void entity_types::ItemEntity::trigger() {
-	auto item = items::make_item(this->name);
-	Game::ACCESS->level.player->inventory.addItem(*item);
+	// Item creation loads textures and inventory belongs to the player, both happen after entity updates
+	EffectBuffer::defer([name = this->name]() {
+		auto item = items::make_item(name);
+		Game::ACCESS->level.player->inventory.addItem(*item);
+	});
 
 	this->mark_for_erase();
 }
@@ -149,13 +144,9 @@ void entity_types::ItemEntity::_init_sprite(const std::string &imageFileName) {
 }
 void entity_types::ItemEntity::_init_solid(const Vector2 &hitboxSize) {
 	this->solid = std::make_unique<SolidRectangle>(
+		solid_profiles::Standard(),
 		this->position,
 		hitboxSize,
-		make_init_list({
-			SolidFlags::AFFECTED_BY_GRAVITY,
-			SolidFlags::SOLID_FOR_TILES,
-			SolidFlags::SOLID_FOR_BORDER
-			}),
 		physics::DEFAULT_MASS_ITEMS,
 		physics::DEFAULT_FRICTION_ITEMS
 		);
@@ -217,13 +208,9 @@ void entity_types::Destructible::_init_sprite(
 }
 void entity_types::Destructible::_init_solid(const Vector2 &hitboxSize) {
 	this->solid = std::make_unique<SolidRectangle>(
+		solid_profiles::Standard(),
 		this->position,
 		hitboxSize,
-		make_init_list({
-			SolidFlags::AFFECTED_BY_GRAVITY,
-			SolidFlags::SOLID_FOR_TILES,
-			SolidFlags::SOLID_FOR_BORDER
-			}),
 		physics::DEFAULT_MASS_CREATURES,
 		physics::DEFAULT_FRICTION_CREATURES
 		);
@@ -32,7 +32,9 @@ namespace entity_primitive_types {
 		// Module inits
 		void _init_sprite(const std::string &imageFileName);
 			// inits controllable sprite, animations are added manualy in derived instances
-		void _init_solid(const Vector2 &hitboxSize, const std::initializer_list<SolidFlags> &flags, double mass, double friction);
+		template<class Profile>
+		void _init_solid(const Vector2 &hitboxSize, double mass, double friction) { this->solid = std::make_unique<SolidRectangle>(Profile(), this->position, hitboxSize, mass, friction); }
+			// inits solid, <Profile> is a 'SolidProfile<>' that determines physics behaviour
 		void _init_health(Fraction fraction, uint maxHp, sint regen, sint physRes = 0, sint magicRes = 0, sint dotRes = 0);
 
 		// Member inits
@@ -77,7 +79,8 @@ namespace entity_primitive_types {
 		virtual void _init_sprite(const std::string &imageFileName, const std::initializer_list< std::pair<Rectangle, Milliseconds> > &frames);
 			// inits either static or animated sprite
 
-		virtual void _optinit_solid(const Vector2 &hitboxSize, const std::initializer_list<SolidFlags> &flags, double mass, double friction);
+		template<class Profile>
+		void _optinit_solid(const Vector2 &hitboxSize, double mass, double friction) { this->solid = std::make_unique<SolidRectangle>(Profile(), this->position, hitboxSize, mass, friction); }
 			// optional, inits solid
 
 	private:
@@ -117,7 +120,7 @@ namespace entity_types {
 		void _init_sprite(const std::string &imageFileName);
 			// inits static sprite (whole image is used as a source rect)
 		void _init_solid(const Vector2 &hitboxSize);
-			// inits solid with standard flags
+			// inits solid with standard profile
 
 		// Member inits
 		void _init_name(const std::string &name);
@@ -151,7 +154,7 @@ namespace entity_types {
 			const std::initializer_list<std::pair<Rectangle, Milliseconds>> &deathAnimationFrames);
 			// inits controllable sprite
 		void _init_solid(const Vector2 &hitboxSize);
-			// inits solid with standard flags
+			// inits solid with standard profile
 		void _init_health(Fraction fraction, uint maxHp, sint regen = 0, sint physRes = 0, sint magicRes = 0, sint dotRes = 0);
 
 		// Member inits
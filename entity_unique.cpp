@@ -2,6 +2,7 @@
 
 #include <functional> // functional types (derived object creation)
 #include <unordered_map> // related type (derived object creation)
+#include <vector> // related type (entity textures)
 
 #include "game.h" // access to game state
 #include "controls.h" // access to control keys
@@ -29,10 +30,27 @@ const std::unordered_map<std::string, make_derived_ptr> ENTITY_MAKERS = {
 	/// new entities go there
 };
 
+// Used to prefetch textures before level is constructed, should match textures used by constructors
+const std::unordered_map<std::string, std::vector<std::string>> ENTITY_TEXTURES = {
+	{"item-brass_relic", { "content/textures/entities/brass_relic.png", "content/textures/items/brass_relic.png" }},
+	{"item-paper", { "content/textures/entities/paper.png", "content/textures/items/paper.png" }},
+	{"destructible-tnt", { "content/textures/entities/tnt.png" }},
+	{"enemy-ghost", { "content/textures/entities/ghost.png", "content/textures/skills/slash.png" }},
+	{"enemy-sludge", { "content/textures/entities/sludge.png" }}
+	/// new entities go there
+};
+
 std::unique_ptr<Entity> entities::make_entity(const std::string &type, const std::string &name, const Vector2d &position) {
 	return ENTITY_MAKERS.at(type + '-' + name)(position); // type and name are joined into a single string
 }
 
+const std::vector<std::string>& entities::get_textures(const std::string &type, const std::string &name) {
+	static const std::vector<std::string> NO_TEXTURES;
+
+	const auto iter = ENTITY_TEXTURES.find(type + '-' + name);
+	return (iter != ENTITY_TEXTURES.end()) ? iter->second : NO_TEXTURES;
+}
+
 
 
 /* ### ITEMS ### */
@@ -141,9 +159,8 @@ entities::enemies::Ghost::Ghost(const Vector2d &position) :
 	// Init modules
 	this->_init_sprite("ghost.png");
 
-	this->_init_solid(
+	this->_init_solid<solid_profiles::Flying>(
 		Vector2(16, 16),
-		{ SolidFlags::SOLID_FOR_BORDER },
 		ghost_consts::MASS,
 		ghost_consts::FRICTION
 	);
@@ -210,7 +227,7 @@ void entities::enemies::Ghost::chase(Milliseconds elapsedTime) {
 	}
 
 	// Move
-	if (std::abs(this->solid->speed.length2()) < ghost_consts::MAX_MOVESPEED2) {
+	if (std::abs(this->solid->speed().length2()) < ghost_consts::MAX_MOVESPEED2) {
 		this->solid->applyForce(this->target_relative_pos.normalized() * ghost_consts::MOVE_FORCE);
 	} /// MAY NEED TO HANDLE EDGE CASE LATER
 
@@ -270,13 +287,8 @@ entities::enemies::Sludge::Sludge(const Vector2d &position) :
 	// Init modules
 	this->_init_sprite("sludge.png");
 
-	this->_init_solid(
+	this->_init_solid<solid_profiles::Standard>(
 		Vector2(16, 16),
-		{
-			SolidFlags::SOLID_FOR_BORDER,
-			SolidFlags::SOLID_FOR_TILES,
-			SolidFlags::AFFECTED_BY_GRAVITY
-		},
 		sludge_consts::MASS,
 		sludge_consts::FRICTION
 	);
@@ -331,8 +343,8 @@ void entities::enemies::Sludge::wander(Milliseconds elapsedTime) {
 		
 	}
 	else {
-		if (this->wander_move && this->solid->isGrounded) { // only move when grounded and 'wander_move' is true
-			if (std::abs(this->solid->speed.length2()) < sludge_consts::WANDER_MOVESPEED2) { // limit speed
+		if (this->wander_move && this->solid->isGrounded()) { // only move when grounded and 'wander_move' is true
+			if (std::abs(this->solid->speed().length2()) < sludge_consts::WANDER_MOVESPEED2) { // limit speed
 				this->solid->applyForce(Vector2d(static_cast<int>(this->orientation) * sludge_consts::MOVE_FORCE, 0));
 			}
 		}
@@ -355,8 +367,8 @@ void entities::enemies::Sludge::chase(Milliseconds elapsedTime) {
 	}
 
 	// Move
-	if (this->solid->isGrounded) { // only move when grounded
-		if (std::abs(this->solid->speed.length2()) < sludge_consts::CHASE_MOVESPEED2) { // limit speed
+	if (this->solid->isGrounded()) { // only move when grounded
+		if (std::abs(this->solid->speed().length2()) < sludge_consts::CHASE_MOVESPEED2) { // limit speed
 			this->solid->applyForce(Vector2d(static_cast<int>(this->orientation) * sludge_consts::MOVE_FORCE, 0));
 		} /// MAY NEED TO HANDLE EDGE CASE LATER
 	}
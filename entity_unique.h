@@ -12,6 +12,9 @@ namespace entities {
 	std::unique_ptr<Entity> make_entity(const std::string &type, const std::string &name, const Vector2d &position);
 		// creates entity of a correct class based on type and name and returns ownership
 
+	const std::vector<std::string>& get_textures(const std::string &type, const std::string &name);
+		// returns paths of all textures used by entity (including its skills and items), empty for unknown entities
+
 
 	
 
@@ -0,0 +1,110 @@
+#include "file_watcher.h"
+
+#include <algorithm> // 'std::find()'
+
+#ifdef __linux__
+#include <sys/inotify.h> // file system events
+#include <unistd.h> // 'read()', 'close()'
+#include <fcntl.h> // 'O_NONBLOCK'
+#include <climits> // 'NAME_MAX'
+#endif
+
+
+
+// # FileWatcher #
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+	if (this->inotify_fd >= 0) { close(this->inotify_fd); }
+#endif
+}
+
+void FileWatcher::watch(const std::string &folder) {
+	this->folder = folder;
+
+#ifdef __linux__
+	this->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (this->inotify_fd >= 0) {
+		this->add_Watch(folder);
+
+		std::error_code error;
+		for (const auto &entry : std::filesystem::recursive_directory_iterator(folder, error)) {
+			if (entry.is_directory()) { this->add_Watch(entry.path().generic_string()); }
+		}
+		return;
+	}
+#endif
+
+	this->scan(nullptr); // remember current state
+}
+
+void FileWatcher::poll(std::vector<std::string> &changed) {
+	changed.clear();
+
+#ifdef __linux__
+	if (this->inotify_fd >= 0) {
+		alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+
+		while (true) {
+			const ssize_t length = read(this->inotify_fd, buffer, sizeof(buffer));
+			if (length <= 0) { break; } // no more events (EAGAIN) or error
+
+			for (ssize_t offset = 0; offset < length;) {
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				const auto folder = this->watched_folders.find(event->wd);
+				if (folder == this->watched_folders.end() || !event->len) { continue; }
+
+				const std::string path = folder->second + "/" + event->name;
+
+				if (event->mask & IN_ISDIR) { // new subfolder
+					if (event->mask & (IN_CREATE | IN_MOVED_TO)) { this->add_Watch(path); }
+					continue;
+				}
+				if (!(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))) { continue; } // file isn't written yet
+
+				if (std::find(changed.begin(), changed.end(), path) == changed.end()) { changed.push_back(path); }
+			}
+		}
+		return;
+	}
+#endif
+
+	// Fallback => compare modification times every once in a while
+	const auto now = std::chrono::steady_clock::now();
+	if (now - this->last_scan < std::chrono::milliseconds(POLLING_INTERVAL)) { return; }
+
+	this->scan(&changed);
+}
+
+void FileWatcher::scan(std::vector<std::string> *changed) {
+	this->last_scan = std::chrono::steady_clock::now();
+
+	std::error_code error;
+	for (const auto &entry : std::filesystem::recursive_directory_iterator(this->folder, error)) {
+		if (!entry.is_regular_file()) { continue; }
+
+		const std::string path = entry.path().generic_string();
+		const auto time = entry.last_write_time(error);
+		if (error) { continue; }
+
+		auto iter = this->modification_times.find(path);
+		if (iter == this->modification_times.end()) {
+			this->modification_times[path] = time;
+			if (changed) { changed->push_back(path); } // new file
+		}
+		else if (iter->second != time) {
+			iter->second = time;
+			if (changed) { changed->push_back(path); }
+		}
+	}
+}
+
+#ifdef __linux__
+void FileWatcher::add_Watch(const std::string &path) {
+	// Editors usually save through a temporary file + rename, so moves count as well, creation is needed for new subfolders
+	const int wd = inotify_add_watch(this->inotify_fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	if (wd >= 0) { this->watched_folders[wd] = path; }
+}
+#endif
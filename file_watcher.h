@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string> // related type
+#include <vector> // related type
+#include <unordered_map> // related type
+#include <filesystem> // 'file_time_type' type (polling)
+#include <chrono> // polling interval
+
+
+
+// # FileWatcher #
+// - Watches a folder (recursively) for modified files
+// - Uses inotify on Linux, on other platforms falls back to polling modification times
+// - Reported paths have the same format as paths used to load content aka "content/levels/[name]{version}.json"
+// - Never blocks, intended to be polled once per frame
+class FileWatcher {
+public:
+	FileWatcher() = default;
+
+	~FileWatcher(); // stops watching
+
+	FileWatcher(const FileWatcher &other) = delete;
+	FileWatcher& operator=(const FileWatcher &other) = delete;
+
+	void watch(const std::string &folder); // starts watching <folder> and all its subfolders
+
+	void poll(std::vector<std::string> &changed); // fills <changed> with files modified since last poll (without duplicates)
+
+	static constexpr int POLLING_INTERVAL = 500; // in milliseconds, used by the fallback
+
+private:
+	void scan(std::vector<std::string> *changed); // updates modification times, reports changes if <changed> isn't nullptr
+
+	std::string folder;
+
+#ifdef __linux__
+	int inotify_fd = -1;
+	std::unordered_map<int, std::string> watched_folders; // watch descriptor => folder path
+
+	void add_Watch(const std::string &path);
+#endif
+
+	std::unordered_map<std::string, std::filesystem::file_time_type> modification_times; // used by the fallback
+	std::chrono::steady_clock::time_point last_scan;
+};
@@ -1,34 +1,34 @@
 #include "game.h"
 
 #include <SDL.h> // 'SDL_Init()' and SDL event system
+#include <algorithm> // 'std::find()' (asset prefetching)
+#include <chrono> // timing of hot reload
+#include <iostream> // hot reload output
+#include <cassert> // pipelining invariant checks
 
 #include "graphics.h" // access to rendering updating
 #include "saver.h" // access to save loading
 #include "emit.h" // acess to 'EmitStorage' (DEV method _drawEmits())
 #include "entity_unique.h" /// TEMP
+#include "tags.h" // tag utility (level preloading)
+#include "level_data.h" // level source paths (hot reload)
 
 
 
 // # Game #
-const Game* Game::READ;
-Game* Game::ACCESS;
+thread_local const Game* Game::READ;
+thread_local Game* Game::ACCESS;
 
+#ifndef HATMAN_HEADLESS
 Game::Game() { // initializes SDL subsystems, starts the game loop
 	this->READ = this;
 	this->ACCESS = this;
 
 	SDL_Init(SDL_INIT_EVERYTHING); /// !!! DETERMINE WHICH INITS ARE NECESSARY !!!
 
-	// Load save file
-	const std::string currentLevelName = Saver::ACCESS->get_CurrentLevel();
-	const std::string currentLevelVersion = Saver::ACCESS->get_LevelVersion(currentLevelName);
-	Vector2d currentPlayerPos = Saver::ACCESS->get_PlayerPosition();
+	this->loadSave();
 
-	this->level = Level(
-		currentLevelName,
-		currentLevelVersion,
-		std::make_unique<Player>(currentPlayerPos)
-		); // init level and player
+	this->content_watcher.watch("content");
 
 	// Turn on some GUI objects
 	Graphics::ACCESS->gui->FPSCounter_on();
@@ -43,6 +43,32 @@ Game::Game() { // initializes SDL subsystems, starts the game loop
 Game::~Game() {
 	SDL_Quit();
 }
+#else
+Game::Game(Milliseconds simulatedTime) { // headless build never inits SDL
+	this->READ = this;
+	this->ACCESS = this;
+
+	this->loadSave();
+
+	this->headlessLoop(simulatedTime);
+}
+#endif
+
+void Game::loadSave() {
+	const std::string currentLevelName = Saver::ACCESS->get_CurrentLevel();
+	const std::string currentLevelVersion = Saver::ACCESS->get_LevelVersion(currentLevelName);
+	Vector2d currentPlayerPos = Saver::ACCESS->get_PlayerPosition();
+
+	this->level = Level(
+		currentLevelName,
+		currentLevelVersion,
+		std::make_unique<Player>(currentPlayerPos)
+		); // init level and player
+
+	this->preloadNeighbors();
+
+	this->camera_previous_position = this->camera_current_position = this->level.player->cameraTrapPos();
+}
 
 void Game::changeLevel(const std::string &mapName, const Vector2d newPosition, int delay) {
 	this->level_change_requested = true;
@@ -50,17 +76,110 @@ void Game::changeLevel(const std::string &mapName, const Vector2d newPosition, i
 	this->level_change_target_version = Saver::ACCESS->get_LevelVersion(mapName);
 	this->level_change_position = newPosition;
 	this->level_change_timer.start(delay);
+
+	this->level_preloader.request(tags::makeTag(this->level_change_target_name, this->level_change_target_version));
+		// no-op if level was already preloaded, otherwise loading starts during the fade
 }
 
 bool Game::levelChangeInProgress() const {
 	return this->level_change_requested;
 }
 
+void Game::deferGUI(std::function<void()> &&change) {
+	this->gui_changes.record(std::move(change)); // only simulation thread records, so no locking is needed
+}
+
+void Game::preloadNeighbors() {
+	std::vector<std::string> neighbors;
+
+	for (const auto &neighborName : this->level.getNeighbors()) {
+		neighbors.push_back(tags::makeTag(neighborName, Saver::ACCESS->get_LevelVersion(neighborName)));
+	}
+
+	this->level_preloader.retain(neighbors); // levels that are no longer reachable are dropped
+	for (const auto &neighbor : neighbors) { this->level_preloader.request(neighbor); }
+
+	this->neighbor_levels = std::move(neighbors);
+	this->prefetched_levels.clear();
+}
+
+void Game::prefetchNeighborAssets() {
+	this->_assertSimulationStopped();
+
+	for (const auto &neighbor : this->neighbor_levels) {
+		if (std::find(this->prefetched_levels.begin(), this->prefetched_levels.end(), neighbor) != this->prefetched_levels.end()) { continue; }
+
+		if (const LevelData* data = this->level_preloader.peek(neighbor)) {
+			Graphics::ACCESS->prefetchTextures(data->textures); // textures are ready by the time player reaches the level
+			this->prefetched_levels.push_back(neighbor);
+		}
+	}
+}
+
+void Game::hotReload() {
+	this->_assertSimulationStopped();
+
+	std::vector<std::string> changed;
+	this->content_watcher.poll(changed);
+
+	bool levelChanged = false;
+
+	for (const auto &path : changed) {
+		const auto startsWith = [&path](const std::string &prefix) { return path.compare(0, prefix.size(), prefix) == 0; };
+
+		if (startsWith("content/textures/")) {
+			if (Graphics::ACCESS->reloadTexture(path)) { std::cout << "$ Reloaded '" << path << "'" << std::endl; }
+			else { std::cout << "$ Size of '" << path << "' has changed, restart to apply" << std::endl; }
+		}
+		else if (startsWith("content/tilesets/")) {
+			Level::forgetTilesets();
+			levelChanged = true;
+		}
+		else if (path == level_data::getSourcePath(tags::makeTag(this->level.getName(), this->level.getVersion()))) {
+			levelChanged = true;
+		}
+	}
+
+	if (levelChanged && !this->level_change_requested) { this->reloadLevel(); }
+}
+
+void Game::reloadLevel() {
+	const auto start = std::chrono::steady_clock::now();
+
+	auto player = std::move(this->level.player); // extract player
+	const Vector2 oldOrigin = this->level.getOrigin();
+
+	Graphics::ACCESS->assets->releaseScope(AssetScope::LEVEL);
+
+	this->level = Level(
+		this->level.getName(),
+		this->level.getVersion(),
+		level_data::load(tags::makeTag(this->level.getName(), this->level.getVersion())),
+		std::move(player)
+	);
+
+	this->level.player->position += oldOrigin - this->level.getOrigin(); // infinite maps shift when they grow to the left/top
+	this->level.player->previous_position = this->level.player->position;
+	this->level.player->resetCameraTrap();
+
+	this->camera_previous_position = this->camera_current_position = this->level.player->cameraTrapPos(); // no interpolation across the shift
+
+	this->preloadNeighbors();
+
+	Graphics::ACCESS->assets->trim();
+
+	const auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	std::cout << "$ Reloaded level in " << time.count() / 1000.0 << " ms" << std::endl;
+}
+
+#ifndef HATMAN_HEADLESS
 void Game::gameLoop() {
 	// The game loop itself
 	SDL_Event event;
 	int LAST_UPDATE_TIME = SDL_GetTicks();
 	while (true) {
+		JobSystem::ACCESS->wait(this->simulation_job); // everything below sees the state after the last simulation
+
 		// Poll user input to the input object
 		this->input.beginNewFrame();
 		if (SDL_PollEvent(&event)) {
@@ -89,52 +208,129 @@ void Game::gameLoop() {
 		int ELAPSED_TIME = CURRENT_TIME - LAST_UPDATE_TIME;
 		LAST_UPDATE_TIME = CURRENT_TIME;
 
-		if (ELAPSED_TIME > 50) { ELAPSED_TIME = 50; } // fix for physics bugging out in low FPS moments
-			// this means below 1000/50=20 FPS physics start to slow down 
+		if (ELAPSED_TIME > MAX_FRAME_TIME) { ELAPSED_TIME = static_cast<int>(MAX_FRAME_TIME); } // after stalls (loading, debugger, etc)
 
 		this->_true_time_elapsed = static_cast<Milliseconds>(ELAPSED_TIME);
 
-		updateGame(ELAPSED_TIME * this->timescale); // this is all there is to timescale mechanic
+		this->hotReload();
+		this->prefetchNeighborAssets();
+
+		// Work that touches the renderer heavily is done here, while simulation is stopped
+		this->applyLevelChange();
+		this->_assertSimulationStopped();
+		this->level.stream();
+
+		this->gui_changes.apply(); // simulation is stopped, so its GUI changes can be applied
+		Graphics::ACCESS->gui->update(ELAPSED_TIME * this->timescale); // GUI is updated once per frame
+
+		// Record state between the last two steps
+		const double alpha = this->simulation_time_accumulated / SIMULATION_STEP;
+
+		this->level.beginInterpolation(alpha);
+		Graphics::ACCESS->camera->position = this->camera_previous_position + (this->camera_current_position - this->camera_previous_position) * alpha;
+
 		drawGame();
+
+		this->level.endInterpolation();
+
+		// Simulate the next frame while this one is rendered, input of this frame is seen by simulation
+		this->simulation_time_accumulated += ELAPSED_TIME * this->timescale; // this is all there is to timescale mechanic
+		this->simulation_job = JobSystem::ACCESS->submit([this]() { this->simulate(); });
+
+		renderGame();
 	}
 }
+#else
+void Game::headlessLoop(Milliseconds simulatedTime) {
+	// Same work as in 'gameLoop()' minus input, GUI and rendering, steps aren't tied to real time
+	for (; simulatedTime >= SIMULATION_STEP; simulatedTime -= SIMULATION_STEP) {
+		this->applyLevelChange();
 
-void Game::updateGame(const Milliseconds elapsedTime) {
-	if (this->level_change_requested && this->level_change_timer.finished()) { // handle level change
-		auto player = std::move(this->level.player); // extract player
-		this->level = Level(
-			this->level_change_target_name,
-			this->level_change_target_version,
-			std::move(player)
-		); // constuct new level and transfer player to it
+		Graphics::ACCESS->camera->position = this->level.player->cameraTrapPos(); // chunks in view are streamed as well
+		this->level.stream();
 
-		this->level.player->position = this->level_change_position; // set player position
+		updateGame(SIMULATION_STEP);
 
-		this->level_change_requested = false;
+		this->gui_changes.apply(); // GUI isn't drawn, but its state (fades, menus) is still kept consistent
 	}
+}
+#endif
 
-	this->level.update(elapsedTime);
+void Game::simulate() {
+	// Simulation advances in fixed steps, leftover time carries over to the next frame
+	while (this->simulation_time_accumulated >= SIMULATION_STEP) {
+		this->camera_previous_position = this->camera_current_position;
 
+		updateGame(SIMULATION_STEP);
 
-	Graphics::ACCESS->gui->update(elapsedTime);
+		this->camera_current_position = this->level.player->cameraTrapPos();
+		this->simulation_time_accumulated -= SIMULATION_STEP;
+	}
+}
+
+void Game::updateGame(const Milliseconds elapsedTime) {
+	this->level.update(elapsedTime);
 
 	EmitStorage::ACCESS->update(elapsedTime);
 
 	TimerController::ACCESS->update(elapsedTime);
+}
+
+void Game::applyLevelChange() {
+	this->_assertSimulationStopped();
+
+	if (this->level_change_requested && this->level_change_timer.finished()) { // handle level change
+		auto player = std::move(this->level.player); // extract player
+
+		Graphics::ACCESS->assets->releaseScope(AssetScope::LEVEL); // textures of the old level stay cached until evicted
+
+		LevelData data;
+		if (this->level_preloader.take(tags::makeTag(this->level_change_target_name, this->level_change_target_version), data)) {
+			this->level = Level(
+				this->level_change_target_name,
+				this->level_change_target_version,
+				std::move(data),
+				std::move(player)
+			); // constuct new level from preloaded description and transfer player to it
+		}
+		else {
+			this->level = Level(
+				this->level_change_target_name,
+				this->level_change_target_version,
+				std::move(player)
+			); // constuct new level and transfer player to it
+		}
+
+		this->level.player->position = this->level_change_position - this->level.getOrigin(); // set player position (target is given in Tiled coordinates)
+		this->level.player->previous_position = this->level.player->position; // teleport, no interpolation
+		this->level.player->resetCameraTrap();
+
+		this->camera_previous_position = this->camera_current_position = this->level.player->cameraTrapPos();
 
-	Graphics::ACCESS->camera->position = this->level.player->cameraTrapPos();
+		this->preloadNeighbors();
+
+		Graphics::ACCESS->assets->trim(); // old level is gone, its textures can be evicted now
+
+		this->level_change_requested = false;
+	}
 }
 
 void Game::drawGame() const {
+	this->_assertSimulationStopped(); // recording reads game state, so it has to happen before simulation is submitted
+
 	this->level.draw();
 
+	Graphics::ACCESS->queue->setLayer(RenderLayer::DEBUG);
+
 	//this->_drawHitboxes(); // enable to display hitboxes
 	this->_drawEmits(); // enable to display emits
 
 	Graphics::ACCESS->gui->draw();
 
 	Graphics::ACCESS->camera->zoom = 1;
+}
 
+void Game::renderGame() const {
 	// Render to screen
 	Graphics::ACCESS->camera->cameraToRenderer(); // draw camera content first
 	Graphics::ACCESS->gui->GUIToRenderer(); // draw GUI content on top
@@ -152,12 +348,14 @@ void Game::_drawHitboxes() const {
 	SDL_Texture* redBorder = Graphics::ACCESS->getTexture("content/textures/hitbox_border.png");
 
 	// Draw tile hitboxes
-	for (const auto &tile : this->level.tiles) {
-		if (tile.hitbox)
-			for (const auto& hitboxRect : tile.hitbox->rectangles) {
-				const SDL_Rect destRect = hitboxRect.toSDLRect();
-				Graphics::ACCESS->camera->textureToCamera(redBorder, NULL, &destRect);
-			}
+	std::vector<const HitboxGrid*> grids;
+	this->level.getHitboxGrids(Graphics::ACCESS->camera->getFOV_Rect(), grids);
+
+	for (const auto grid : grids) {
+		for (size_t i = 0; i < grid->size(); ++i) {
+			const SDL_Rect destRect = grid->getRect(i).toSDLRect();
+			Graphics::ACCESS->camera->textureToCamera(redBorder, NULL, &destRect);
+		}
 	}
 
 	// Draw entity hitboxes
@@ -179,8 +377,8 @@ void Game::_drawEmits() const {
 
 	/// TEMP
 	font->color_set(RGBColor(255, 0, 0));
-	font->draw_line(Vector2(200, 2), std::to_string(this->level.player->solid->speed.x));
-	font->draw_line(Vector2(400, 2), std::to_string(this->level.player->solid->speed.y));
+	font->draw_line(Vector2(200, 2), std::to_string(this->level.player->solid->speed().x));
+	font->draw_line(Vector2(400, 2), std::to_string(this->level.player->solid->speed().y));
 	/// TEMP
 
 
@@ -197,4 +395,8 @@ void Game::_drawEmits() const {
 		cursor.x = start.x;
 		cursor.y += font->get_monospace().y;
 	}
+}
+
+void Game::_assertSimulationStopped() const {
+	assert(JobSystem::READ->finished(this->simulation_job) && "Main thread touched game state while simulation is running");
 }
\ No newline at end of file
@@ -3,26 +3,44 @@
 #include "timer.h" // 'Timer' class, 'Milliseconds' type
 #include "input.h" // 'Input' class
 #include "level.h" // 'Level' class
+#include "level_preloader.h" // 'LevelPreloader' class
+#include "file_watcher.h" // 'FileWatcher' class (hot reload)
+#include "job_system.h" // 'JobHandle' type (simulation runs in parallel with rendering)
+#include "effect_buffer.h" // 'EffectBuffer' class (GUI changes requested by simulation)
 
 
 
 
 // # Game #
-// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields
+// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields (per instance, see 'InstanceContext')
 // - Holds the game loop
 // - Handles most high-level logic
+// - Simulation and rendering are pipelined as record-then-simulate: main thread records the current frame into
+// 'RenderQueue' ('drawGame()'), then simulation of the next frame runs on 'JobSystem' while main thread submits
+// the recorded commands ('renderGame()'), there is no second copy of game state
+// - Invariant: while 'simulation_job' is pending main thread doesn't touch game state (level, entities, player,
+// storages of the instance), rendering only reads the queue and 'Graphics' state which simulation never writes,
+// debug builds check it through '_assertSimulationStopped()'
+// - GUI is read by rendering, so simulation never touches it directly, it requests changes through 'deferGUI()'
+// and main thread applies them once simulation is over
 class Game {
 public:
+#ifndef HATMAN_HEADLESS
 	Game(); // inits SDL
 
 	~Game(); // quits SDL
+#else
+	Game(Milliseconds simulatedTime); // headless build, simulates given amount of game time as fast as possible (no input or drawing)
+#endif
 
-	static const Game* READ; // used for aka 'global' access
-	static Game* ACCESS;
+	static thread_local const Game* READ; // used for aka 'global' access
+	static thread_local Game* ACCESS;
 
 	void changeLevel(const std::string &mapName, const Vector2d newPosition, int delay); // changes level to given, version is loaded from save
 	bool levelChangeInProgress() const; // returns whether level change is in progress
 
+	void deferGUI(std::function<void()> &&change); // <change> is applied to GUI by main thread after current simulation
+
 	double timescale = 1;
 
 	Level level;
@@ -35,19 +53,51 @@ public:
 		// used by some GUI things that calculate time independent from timescale
 		// mostly here for FPS counter
 
+	static constexpr Milliseconds SIMULATION_STEP = 1000. / 120; // level is always updated with this timestep (120 Hz)
+	static constexpr Milliseconds MAX_FRAME_TIME = 250; // longer frames are clamped, so simulation doesn't spiral trying to catch up
+
 private:
+	void loadSave(); // creates level and player from savefile
+
+#ifndef HATMAN_HEADLESS
 	void gameLoop();
+#else
+	void headlessLoop(Milliseconds simulatedTime);
+#endif
+
+	void simulate(); // runs all whole steps that fit into accumulated time, runs in parallel with rendering
+	void updateGame(Milliseconds elapsedTime); // updates simulation by a single step
+	void applyLevelChange(); // swaps level once the fade is over, touches the renderer so it's done between simulation runs
+	void drawGame() const; // records everything into render queue, this is the snapshot rendered in parallel with simulation
+	void renderGame() const; // renders recorded snapshot to screen, doesn't touch game state
+
+	void preloadNeighbors(); // starts background loading of levels reachable from the current one
+	void prefetchNeighborAssets(); // starts loading textures of neighbor levels that finished preloading
 
-	void updateGame(Milliseconds elapsedTime); // updates everything
-	void drawGame() const; // draws everything
+	void hotReload(); // reloads content that was modified on disk
+	void reloadLevel(); // rebuilds current level from its file, player is preserved
 
 	// DEVELOPER METHODS, used for debugging and testing!
 	void _drawHitboxes() const; // shows a red outline of all hitboxes
 	void _drawEmits() const; // shows content of EmitStorage
+	void _assertSimulationStopped() const; // fails in debug builds if simulation is running (see pipelining invariant above)
 
 	bool level_change_requested = false; // true if level change was requested
 	std::string level_change_target_name; // name of the level to change
 	std::string level_change_target_version; // version of the level loaded from save
 	Vector2d level_change_position; // player position on a new level
 	Timer level_change_timer; // waits for level change animation to finish
+
+	LevelPreloader level_preloader; // loads neighbor levels in background
+	std::vector<std::string> neighbor_levels; // full map names of levels reachable from the current one
+	std::vector<std::string> prefetched_levels; // neighbors which textures are already loading
+
+	FileWatcher content_watcher; // watches 'content/' folder for hot reload
+
+	Milliseconds simulation_time_accumulated = 0; // frame time that wasn't simulated yet (less than a step)
+	Vector2d camera_previous_position; // camera positions before and after the last step, drawing interpolates between them
+	Vector2d camera_current_position;
+
+	JobHandle simulation_job; // simulation of the next frame, main thread waits for it before touching game state
+	EffectBuffer gui_changes; // requested by simulation, applied by main thread after 'simulation_job'
 };
\ No newline at end of file
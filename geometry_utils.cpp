@@ -1,8 +1,10 @@
 #include "geometry_utils.h"
 
 #include <cmath> // 'sqrt()' function (Vector2 length calculation)
-#include <cstdlib> // 'abs()' for int, 'rand()'
+#include <cstdlib> // 'abs()' for int
 #include <time.h> // used to generate seed for random
+#include <random> // 'std::mt19937' (thread-safe random)
+#include <thread> // thread ids (seeding random)
 
 
 
@@ -172,14 +174,10 @@ Orientation helpers::invert(Orientation orientation) {
 }
 
 int helpers::dice(int min, int max) {
-	static bool firstExecution = true;
+	// Every thread has its own generator since entities are updated in parallel
+	thread_local std::mt19937 generator(static_cast<unsigned>(time(nullptr)) ^ static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id())));
 
-	if (firstExecution) {
-		srand(time(nullptr));
-		firstExecution = false;
-	}
-
-	return min + rand() % (max - min + 1);
+	return std::uniform_int_distribution<int>(min, max)(generator);
 }
 
 
@@ -1,21 +1,28 @@
+// Left out of headless build, see 'graphics_headless.cpp'
+#ifndef HATMAN_HEADLESS
+
 #include "graphics.h"
 
 #include <SDL_image.h> // loading of texture from image files
+#include <filesystem> // listing of texture folders (atlas)
+#include <cassert> // main thread checks
 #include "globalconsts.hpp" // rendering consts
 
 
 
 // # Graphics #
-const Graphics* Graphics::READ;
-Graphics* Graphics::ACCESS;
+thread_local const Graphics* Graphics::READ;
+thread_local Graphics* Graphics::ACCESS;
 
 // Construction and creation of a window and renderer
-Graphics::Graphics(const LaunchInfo &launchInfo)
+Graphics::Graphics(const LaunchInfo &launchInfo) :
+	main_thread(std::this_thread::get_id())
 {
 	Graphics::READ = this; // init global access
 	Graphics::ACCESS = this;
 
 	SDL_Init(SDL_INIT_VIDEO);
+	IMG_Init(IMG_INIT_PNG); // loads PNG decoder upfront, lazy loading isn't safe while decoding on several threads
 
 	SDL_CreateWindowAndRenderer(launchInfo.window_width, launchInfo.window_height, launchInfo.window_flag, &this->window, &this->renderer);
 
@@ -29,10 +36,21 @@ Graphics::Graphics(const LaunchInfo &launchInfo)
 	SDL_SetRenderDrawColor(this->renderer, 0, 0, 0, 0); // set SDL_RenderClear() color to transparent, necessary for proper blending
 	SDL_SetWindowTitle(this->window, "Hatman Adventure");
 
+	this->batch = std::make_unique<SpriteBatch>(this->renderer);
+	this->queue = std::make_unique<RenderQueue>();
+	this->atlas = std::make_unique<TextureAtlas>(this->renderer);
+	this->decoder = std::make_unique<ImageDecoder>();
+	this->assets = std::make_unique<AssetRegistry>(
+		[this](const std::string &filePath, size_t &bytes) { return this->load_Texture(filePath, bytes); },
+		[this](SDL_Texture* texture) { this->unload_Texture(texture); }
+	);
 	this->camera = std::make_unique<Camera>();
 	this->gui = std::make_unique<Gui>();
 }
 Graphics::~Graphics() {
+	this->gui.reset(); // backbuffers are destroyed through the batch, so it has to outlive them
+	this->camera.reset();
+
 	this->unloadImages();
 	SDL_DestroyRenderer(this->renderer);
 	SDL_DestroyWindow(this->window);
@@ -40,12 +58,23 @@ Graphics::~Graphics() {
 
 // Image loading
 SDL_Texture* Graphics::getTexture(const std::string &filePath) {
-	if (!this->loadedImages.count(filePath)) { // image is not loaded => load it, add to the map
-		SDL_Surface* loadedSurface = IMG_Load(filePath.c_str()); // IMG_Load() accepts only C-string
-		this->loadedImages[filePath] = SDL_CreateTextureFromSurface(this->renderer, loadedSurface);
-		SDL_FreeSurface(loadedSurface);
+	if (!this->atlas_built) {
+		assert(this->onMainThread() && "Atlas has to be built by main thread before simulation starts");
+		this->build_Atlas();
 	}
-	return this->loadedImages.at(filePath);
+
+	const auto atlasImage = this->atlasImages.find(filePath);
+	if (atlasImage != this->atlasImages.end()) { return atlasImage->second; }
+
+	return this->getTexture(this->assets->find(filePath));
+}
+SDL_Texture* Graphics::getTexture(TextureHandle handle) {
+	if (this->onMainThread()) { return this->assets->acquire(handle); }
+
+	// Simulation => texture has to be resident, atlas build loads everything simulation can request
+	SDL_Texture* texture = this->assets->acquireResident(handle);
+	assert(texture && "Simulation requested a texture that isn't resident, only main thread can load textures");
+	return texture;
 }
 SDL_Texture* Graphics::getTexture_Entity(const std::string &name) {
 	return this->getTexture("content/textures/entities/" + name);
@@ -66,26 +95,183 @@ SDL_Texture* Graphics::getTexture_GUI(const std::string &name) {
 	return this->getTexture("content/textures/gui/" + name);
 }
 void Graphics::unloadImages() { 
-	for (auto& element : this->loadedImages) {
-		SDL_DestroyTexture(element.second);
+	this->queue->submit();
+	this->batch->flush(); // pending geometry might use these textures
+
+	this->decoder->cancel(); // decodes might target these textures
+
+	this->assets->clear();
+	this->batch->forgetTextures();
+
+	this->atlasImages.clear();
+	this->atlas->clear();
+	this->atlas_built = false;
+}
+
+bool Graphics::reloadTexture(const std::string &filePath) {
+	// Atlas image => overwrite its region of the atlas page
+	const auto atlasImage = this->atlasImages.find(filePath);
+	if (atlasImage != this->atlasImages.end()) {
+		const _atlas_region* region = this->atlas->find(atlasImage->second);
+
+		SDL_Surface* surface = ImageDecoder::decode(filePath);
+		if (!surface) { return true; } // file is probably still being written, next change will fix it
+
+		const bool sameSize = (surface->w == region->rect.w && surface->h == region->rect.h);
+		if (sameSize) {
+			this->batch->flush(); // pending geometry might use the page
+			SDL_UpdateTexture(region->page, &region->rect, surface->pixels, surface->pitch);
+		}
+		SDL_FreeSurface(surface);
+
+		return sameSize;
+	}
+
+	// Regular texture => decode again in background
+	SDL_Texture* texture = this->assets->get(this->assets->find(filePath));
+	if (!texture) { return true; } // not loaded, next load will read the new file anyway
+
+	Vector2 size;
+	const Vector2 currentSize = this->getTextureSize(texture);
+	if (!ImageDecoder::readSize(filePath, size) || size.x != currentSize.x || size.y != currentSize.y) { return false; }
+
+	this->decoder->cancel(texture); // older decode might finish after the new one
+	this->decoder->request(texture, filePath);
+
+	return true;
+}
+
+void Graphics::prefetchTextures(const std::vector<std::string> &filePaths) {
+	if (!this->atlas_built) { this->build_Atlas(); }
+
+	for (const auto &path : filePaths) {
+		if (!this->atlasImages.count(path)) { this->assets->prefetch(this->assets->find(path)); } // loading is asynchronous, so this doesn't block
+	}
+}
+
+Vector2 Graphics::getTextureSize(SDL_Texture* texture) const {
+	if (const _atlas_region* region = this->atlas->find(texture)) { return Vector2(region->rect.w, region->rect.h); }
+
+	Vector2 size;
+	SDL_QueryTexture(texture, NULL, NULL, &size.x, &size.y);
+	return size;
+}
+
+SDL_Texture* Graphics::load_Texture(const std::string &filePath, size_t &bytes) {
+	assert(this->onMainThread() && "Textures can only be loaded by main thread");
+
+	Vector2 size;
+	if (ImageDecoder::readSize(filePath, size)) {
+		bytes = static_cast<size_t>(size.x) * size.y * 4; // all textures are 32-bit
+
+		// Create transparent texture of the right size right away, pixels are uploaded once decoding finishes
+		SDL_Texture* texture = SDL_CreateTexture(this->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, size.x, size.y);
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+		const std::vector<Uint32> transparent(static_cast<size_t>(size.x) * size.y, 0);
+		SDL_UpdateTexture(texture, NULL, transparent.data(), size.x * sizeof(Uint32));
+
+		this->decoder->request(texture, filePath);
+		return texture;
+	}
+
+	// Size can't be known in advance => load synchronously
+	SDL_Surface* loadedSurface = ImageDecoder::decode(filePath);
+	if (!loadedSurface) { return nullptr; }
+
+	bytes = static_cast<size_t>(loadedSurface->w) * loadedSurface->h * 4;
+	SDL_Texture* texture = SDL_CreateTextureFromSurface(this->renderer, loadedSurface);
+	SDL_FreeSurface(loadedSurface);
+	return texture;
+}
+
+void Graphics::unload_Texture(SDL_Texture* texture) {
+	assert(this->onMainThread() && "Textures can only be unloaded by main thread");
+
+	// Only unreferenced textures are unloaded, so nothing is pending in the queue or batch
+	this->decoder->cancel(texture);
+	this->batch->forgetTexture(texture);
+
+	SDL_DestroyTexture(texture);
+}
+
+void Graphics::build_Atlas() {
+	const std::string folders[] = {
+		"content/textures/",
+		"content/textures/entities/",
+		"content/textures/items/",
+		"content/textures/skills/",
+		"content/textures/gui/"
+	}; // tilesets are pre-rendered by chunks, backgrounds are too large
+
+	std::vector<std::string> filePaths;
+	for (const auto &folder : folders) {
+		std::error_code error;
+		for (const auto &entry : std::filesystem::directory_iterator(folder, error)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".png") {
+				filePaths.push_back(folder + entry.path().filename().string()); // same format as paths passed to 'getTexture()'
+			}
+		}
+	}
+
+	this->atlasImages = this->atlas->build(filePaths);
+	this->atlas_built = true;
+
+	// Images that didn't fit stay referenced for good, so simulation can always get them without loading
+	for (const auto &path : filePaths) {
+		if (!this->atlasImages.count(path)) { this->assets->acquire(this->assets->find(path)); } // no scope pushed => GLOBAL
 	}
 }
 
 // Rendering
 SDL_Renderer* Graphics::getRenderer() const { return this->renderer; } 
-void Graphics::rendererToWindow() {	SDL_RenderPresent(this->renderer); }
+bool Graphics::onMainThread() const { return std::this_thread::get_id() == this->main_thread; }
+const DrawStats& Graphics::getDrawStats() const { return this->batch->getStats(); }
+void Graphics::rendererToWindow() {
+	this->queue->submit();
+	this->batch->endFrame(); // submit everything that is left
+
+	SDL_RenderPresent(this->renderer);
+}
 void Graphics::rendererClear() {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), NULL); // take rendering target
+	this->batch->flush(NULL);
+
+	this->decoder->upload(); // textures decoded during the frame become visible on the next one
+
+	this->batch->setTarget(NULL); // take rendering target
 
 	SDL_RenderClear(this->renderer); 
 }
 void Graphics::copyTextureToRenderer(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect) {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), NULL); // take rendering target
-
-	SDL_RenderCopy(this->renderer, texture, sourceRect, destRect);
+	this->batch->add(NULL, texture, sourceRect, destRect); // NULL target => renderer
 }
 void Graphics::copyTextureToRendererEx(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip) {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), NULL); // take rendering target
+	this->batch->add(NULL, texture, sourceRect, destRect, angle, flip);
+}
+
+// Render targets
+SDL_Texture* Graphics::createTarget(const Vector2 &size) {
+	assert(this->onMainThread() && "Render targets can only be created by main thread");
+
+	SDL_Texture* texture = SDL_CreateTexture(this->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y);
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND); // necessary for proper blending of transparent parts
+
+	return texture;
+}
+void Graphics::destroyTarget(SDL_Texture* texture) {
+	assert(this->onMainThread() && "Render targets can only be destroyed by main thread");
+
+	this->batch->flush(texture); // batch shouldn't keep geometry for a destroyed target
+	this->batch->forgetTexture(texture);
+
+	SDL_DestroyTexture(texture);
+}
+void Graphics::clearTarget(SDL_Texture* target) {
+	this->batch->flush(target);
+
+	this->batch->setTarget(target);
+
+	SDL_RenderClear(this->renderer); // renderer clear color is transparent
+}
 
-	SDL_RenderCopyEx(this->renderer, texture, sourceRect, destRect, angle, NULL, flip);
-}
\ No newline at end of file
+#endif // !HATMAN_HEADLESS
\ No newline at end of file
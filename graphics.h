@@ -3,12 +3,21 @@
 #include <SDL.h> // rendering
 #include <unordered_map> // related type
 #include <memory> // 'unique_ptr' type
+#include <thread> // 'std::thread::id' type (main thread)
 #include <string> // related type
+#include <vector> // related type
 
 #include "geometry_utils.h" // geometry types
 #include "launch_info.h" // 'LaunchInfo' class
 #include "gui.h" // 'Gui' module
 #include "camera.h" // 'Camera' module
+#include "sprite_batch.h" // 'SpriteBatch' module
+#include "render_queue.h" // 'RenderQueue' module
+#include "texture_atlas.h" // 'TextureAtlas' module
+#include "asset_registry.h" // 'AssetRegistry' module
+#ifndef HATMAN_HEADLESS
+#include "image_decoder.h" // 'ImageDecoder' module
+#endif
 
 
 
@@ -18,9 +27,16 @@ class Camera;
 
 
 // # Graphics #
-// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields
+// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields (per instance, see 'InstanceContext')
 // - Handles window creation, rendering and loading of images
 // - Only one instance at a time should exits (creation of new instances however is not controlled in any way)
+// - Headless build (HATMAN_HEADLESS defined) leaves out SDL-backed modules ('graphics.cpp', 'sprite_batch.cpp',
+// 'texture_atlas.cpp', 'image_decoder.cpp'), 'graphics_headless.cpp' implements them without SDL calls,
+// there is no window or renderer, textures are never loaded and requests return nullptr
+// - Renderer isn't thread-safe, everything that touches it (loading textures, render targets, drawing) is done
+// by the thread that created 'Graphics' (main thread)
+// - Simulation runs on other threads and never loads textures, it only gets resident ones: images of atlas folders
+// are either packed or loaded and referenced for good upon atlas build (see 'build_Atlas()')
 class Graphics {
 public:
 	Graphics() = delete;
@@ -29,13 +45,24 @@ public:
 
 	~Graphics(); // frees loaded textures
 
-	static const Graphics* READ; // used for aka 'global' access
-	static Graphics* ACCESS;
+	static thread_local const Graphics* READ; // used for aka 'global' access
+	static thread_local Graphics* ACCESS;
 
 	std::unique_ptr<Camera> camera;
 	std::unique_ptr<Gui> gui;
+	std::unique_ptr<SpriteBatch> batch; // all texture drawing goes through it
+	std::unique_ptr<RenderQueue> queue; // world and GUI drawing is recorded here and submitted once per frame
+	std::unique_ptr<TextureAtlas> atlas; // small textures are packed here upon first texture request
+#ifndef HATMAN_HEADLESS
+	std::unique_ptr<ImageDecoder> decoder; // decodes images requested through 'getTexture()' in background
+#endif
+	std::unique_ptr<AssetRegistry> assets; // owns all textures except atlas ones, handles their lifetime and VRAM budget
 
 	SDL_Texture* getTexture(const std::string &filePath);
+		// returns texture right away, image is decoded in background and texture stays transparent until it's done
+		// adds a reference in current 'AssetScope', so texture won't be evicted while it's used
+		// called from other threads than main one only returns resident textures, nullptr otherwise
+	SDL_Texture* getTexture(TextureHandle handle); // same as above, but skips the path lookup
 	// Cases of getTexture() (convenience thing)
 	SDL_Texture* getTexture_Entity(const std::string &name);
 	SDL_Texture* getTexture_Ability(const std::string &name);
@@ -44,7 +71,14 @@ public:
 	SDL_Texture* getTexture_Background(const std::string &name);
 	SDL_Texture* getTexture_GUI(const std::string &name);
 
-	void unloadImages(); // clears the map of loaded images
+	bool reloadTexture(const std::string &filePath);
+		// re-reads image into existing texture (hot reload), no-op for textures that aren't loaded
+		// returns false if image size has changed, since existing texture can't be resized in place
+	void prefetchTextures(const std::vector<std::string> &filePaths); // starts loading of textures that aren't loaded yet
+
+	Vector2 getTextureSize(SDL_Texture* texture) const; // works both with regular textures and atlas handles
+
+	void unloadImages(); // unloads all textures
 
 	void rendererToWindow(); // draws content of backbuffer (renderer) to screen
 	void rendererClear(); // clears content of renderer (used each frame)
@@ -54,11 +88,33 @@ public:
 	void copyTextureToRendererEx(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip = SDL_FLIP_NONE);
 		// same as above but allows rotation and flips
 
+	SDL_Texture* createTarget(const Vector2 &size); // creates transparent texture that can be rendered to (backbuffers, pre-rendered chunks)
+	void destroyTarget(SDL_Texture* texture); // destroys texture made by 'createTarget()'
+	void clearTarget(SDL_Texture* target); // submits pending drawing to <target>, redirects rendering to it and clears it
+
 	SDL_Renderer* getRenderer() const; // returns renderer			
 
+	bool onMainThread() const; // returns whether current thread is the one allowed to touch renderer
+
+	const DrawStats& getDrawStats() const; // returns rendering stats of the last frame
+
+#ifdef HATMAN_HEADLESS
+	static constexpr bool HEADLESS = true; // nothing is ever drawn, parts of the level that are only drawn can be skipped
+#else
+	static constexpr bool HEADLESS = false;
+#endif
+
 private:
-	SDL_Window* window;
-	SDL_Renderer* renderer;
+	SDL_Window* window = nullptr;
+	SDL_Renderer* renderer = nullptr; // nullptr in headless build
+
+	std::thread::id main_thread; // thread that created 'Graphics'
+
+	std::unordered_map<std::string, SDL_Texture*> atlasImages; // handles of packed images, owned by 'atlas'
+	bool atlas_built = false;
+
+	void build_Atlas(); // packs textures of entities, items, skills and GUI, loads ones that weren't packed
 
-	std::unordered_map<std::string, SDL_Texture*> loadedImages; // all loaded images are saved here as SDL_Surface
+	SDL_Texture* load_Texture(const std::string &filePath, size_t &bytes); // used by 'assets'
+	void unload_Texture(SDL_Texture* texture);
 };
\ No newline at end of file
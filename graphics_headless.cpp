@@ -0,0 +1,132 @@
+// Headless build only, replaces SDL-backed modules ('graphics.cpp', 'sprite_batch.cpp', 'texture_atlas.cpp', 'image_decoder.cpp')
+#ifdef HATMAN_HEADLESS
+
+#include "graphics.h"
+
+
+
+// # Graphics #
+// - No window, renderer or textures, drawing calls do nothing
+// - Camera, GUI and render queue are still present since simulation uses their state
+thread_local const Graphics* Graphics::READ;
+thread_local Graphics* Graphics::ACCESS;
+
+Graphics::Graphics(const LaunchInfo &launchInfo) :
+	main_thread(std::this_thread::get_id())
+{
+	Graphics::READ = this; // init global access
+	Graphics::ACCESS = this;
+
+	this->batch = std::make_unique<SpriteBatch>(nullptr);
+	this->queue = std::make_unique<RenderQueue>();
+	this->atlas = std::make_unique<TextureAtlas>(nullptr);
+	this->assets = std::make_unique<AssetRegistry>(
+		[](const std::string &filePath, size_t &bytes) -> SDL_Texture* { return nullptr; }, // textures are never loaded
+		[](SDL_Texture* texture) {}
+	);
+	this->camera = std::make_unique<Camera>();
+	this->gui = std::make_unique<Gui>();
+}
+Graphics::~Graphics() {
+	this->gui.reset(); // same order as in a regular build
+	this->camera.reset();
+}
+
+// Image loading
+SDL_Texture* Graphics::getTexture(const std::string &filePath) { return nullptr; }
+SDL_Texture* Graphics::getTexture(TextureHandle handle) { return nullptr; }
+SDL_Texture* Graphics::getTexture_Entity(const std::string &name) { return nullptr; }
+SDL_Texture* Graphics::getTexture_Ability(const std::string &name) { return nullptr; }
+SDL_Texture* Graphics::getTexture_Item(const std::string &name) { return nullptr; }
+SDL_Texture* Graphics::getTexture_Tileset(const std::string &name) { return nullptr; }
+SDL_Texture* Graphics::getTexture_Background(const std::string &name) { return nullptr; }
+SDL_Texture* Graphics::getTexture_GUI(const std::string &name) { return nullptr; }
+
+bool Graphics::reloadTexture(const std::string &filePath) { return true; }
+void Graphics::prefetchTextures(const std::vector<std::string> &filePaths) {}
+
+Vector2 Graphics::getTextureSize(SDL_Texture* texture) const { return Vector2(); }
+
+void Graphics::unloadImages() {}
+
+// Rendering
+SDL_Renderer* Graphics::getRenderer() const { return nullptr; }
+bool Graphics::onMainThread() const { return std::this_thread::get_id() == this->main_thread; }
+const DrawStats& Graphics::getDrawStats() const { return this->batch->getStats(); }
+void Graphics::rendererToWindow() {
+	this->queue->submit(); // recorded draws still reach the batch, which only counts them
+	this->batch->endFrame();
+}
+void Graphics::rendererClear() {}
+void Graphics::copyTextureToRenderer(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect) {}
+void Graphics::copyTextureToRendererEx(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip) {}
+
+// Render targets
+SDL_Texture* Graphics::createTarget(const Vector2 &size) { return nullptr; }
+void Graphics::destroyTarget(SDL_Texture* texture) {}
+void Graphics::clearTarget(SDL_Texture* target) {}
+
+
+
+// # SpriteBatch #
+// - Only tracks state that is visible to the rest of the game (texture mods, stats)
+SpriteBatch::SpriteBatch(SDL_Renderer* renderer) :
+	renderer(renderer)
+{}
+
+void SpriteBatch::add(SDL_Texture* target, SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip) {}
+void SpriteBatch::add(SDL_Texture* target, SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip, const SDL_Color &mod) {}
+
+void SpriteBatch::flush() {}
+void SpriteBatch::flush(SDL_Texture* target) {}
+
+void SpriteBatch::endFrame() {
+	this->stats_last = this->stats_current;
+	this->stats_current = DrawStats();
+}
+
+void SpriteBatch::countCulled() {
+	++this->stats_current.culled_sprites;
+}
+
+void SpriteBatch::setTarget(SDL_Texture* target) {
+	this->current_target = target;
+	this->current_target_known = true;
+}
+
+void SpriteBatch::setTextureMod(SDL_Texture* texture, const SDL_Color &mod) {
+	this->texture_mods[texture] = mod;
+}
+SDL_Color SpriteBatch::getTextureMod(SDL_Texture* texture) const {
+	const auto iter = this->texture_mods.find(texture);
+	return (iter != this->texture_mods.end()) ? iter->second : SDL_Color{ 255, 255, 255, 255 };
+}
+void SpriteBatch::forgetTexture(SDL_Texture* texture) {
+	this->texture_mods.erase(texture);
+}
+void SpriteBatch::forgetTextures() {
+	this->texture_mods.clear();
+}
+
+const DrawStats& SpriteBatch::getStats() const {
+	return this->stats_last;
+}
+
+
+
+// # TextureAtlas #
+// - Never has any pages, so no texture is a handle
+TextureAtlas::TextureAtlas(SDL_Renderer* renderer) :
+	renderer(renderer)
+{}
+
+TextureAtlas::~TextureAtlas() {}
+
+std::unordered_map<std::string, SDL_Texture*> TextureAtlas::build(const std::vector<std::string> &filePaths) { return {}; }
+void TextureAtlas::clear() {}
+
+const _atlas_region* TextureAtlas::find(SDL_Texture* handle) const { return nullptr; }
+
+size_t TextureAtlas::pageCount() const { return 0; }
+
+#endif // HATMAN_HEADLESS
@@ -5,6 +5,7 @@
 #include "item_base.h" // 'Inventory' and 'Item' classes (inventory GUI)
 #include "game.h" // access to game state
 #include "controls.h" // access to control keys
+#include "job_system.h" // worker utilization (FPS counter)
 
 
 
@@ -108,12 +109,10 @@ Vector2 Font::draw_line(const Vector2 &position, const std::string &line, bool o
 }
 
 void Font::color_set(const RGBColor &color) {
-	SDL_SetTextureColorMod(this->font_texture, color.r, color.g, color.b);
-	SDL_SetTextureAlphaMod(this->font_texture, color.alpha);
+	Graphics::ACCESS->batch->setTextureMod(this->font_texture, { color.r, color.g, color.b, color.alpha });
 }
 void Font::color_reset() {
-	SDL_SetTextureColorMod(this->font_texture, 255, 255, 255);
-	SDL_SetTextureAlphaMod(this->font_texture, 255);
+	Graphics::ACCESS->batch->setTextureMod(this->font_texture, { 255, 255, 255, 255 });
 }
 
 Vector2 Font::get_size() const {
@@ -152,6 +151,8 @@ void Text::update(Milliseconds elapsedTime) {
 }
 
 void Text::draw() const {
+	if (!this->overlay && !Graphics::READ->camera->inView(this->bounds)) { return; } // world-space text outside of view
+
 	this->font->color_set(this->color);
 
 	const Vector2 letterSize = this->font->get_monospace();
@@ -286,8 +287,25 @@ void GUI_FPSCounter::update(Milliseconds elapsedTime) {
 		this->time_elapsed = 0;
 		this->frames_elapsed = 0;
 
+		const DrawStats &drawStats = Graphics::READ->getDrawStats();
+
+		// Average utilization of workers since the last counter update
+		double utilization = 0;
+		const auto workerStats = JobSystem::READ->getStats();
+		for (const auto &stats : workerStats) { utilization += stats.utilization; }
+		if (!workerStats.empty()) { utilization /= workerStats.size(); }
+		JobSystem::ACCESS->resetStats();
+
 		text_handle.erase();
-		this->text_handle = Graphics::ACCESS->gui->make_line(std::to_string(this->currentFPS), this->position);
+		this->text_handle = Graphics::ACCESS->gui->make_line(
+			std::to_string(this->currentFPS) + " fps  " +
+			std::to_string(drawStats.draw_calls) + " draws  " +
+			std::to_string(drawStats.sprites) + " sprites  " +
+			std::to_string(drawStats.culled_sprites) + " culled sprites  " +
+			std::to_string(drawStats.state_changes_skipped) + " state skips  " +
+			std::to_string(static_cast<int>(utilization * 100)) + "% jobs",
+			this->position
+		);
 		this->text_handle.get().set_color(0, 0, 0); // black
 	}
 }
@@ -395,7 +413,7 @@ GUI_Portrait::GUI_Portrait(Forms playerForm) {
 	}
 
 	// Set size
-	SDL_QueryTexture(this->texture, NULL, NULL, &this->size.x, &this->size.y);
+	this->size = Graphics::READ->getTextureSize(this->texture);
 }
 
 void GUI_Portrait::update(Milliseconds elapsedTime) {
@@ -525,8 +543,7 @@ GUI_Fade::GUI_Fade(const RGBColor &color) :
 
 void GUI_Fade::update(Milliseconds elapsedTime) {}
 void GUI_Fade::draw() const {
-	SDL_SetTextureColorMod(this->texture, this->color.r, this->color.g, this->color.b);
-	SDL_SetTextureAlphaMod(this->texture, this->color.alpha);
+	Graphics::ACCESS->batch->setTextureMod(this->texture, { this->color.r, this->color.g, this->color.b, this->color.alpha });
 
 	Graphics::ACCESS->gui->textureToGUI(this->texture, NULL, NULL);
 }
@@ -679,12 +696,8 @@ void Gui::InventoryGUI::draw_tab_items() const {
 Gui::Gui() :
 	FPS_counter(nullptr)
 {
-	this->backbuffer = SDL_CreateTexture(
-		Graphics::ACCESS->getRenderer(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
-		rendering::RENDERING_WIDTH, rendering::RENDERING_HEIGHT
-	);
+	this->backbuffer = Graphics::ACCESS->createTarget(Vector2(rendering::RENDERING_WIDTH, rendering::RENDERING_HEIGHT));
 
-	SDL_SetTextureBlendMode(this->backbuffer, SDL_BLENDMODE_BLEND); // necessary for proper blending of of transparent parts
 	this->fonts["BLOCKY"] = (std::make_unique<Font>(
 		Graphics::ACCESS->getTexture_GUI("font.png"),
 		Vector2(5, 5),
@@ -693,7 +706,7 @@ Gui::Gui() :
 }
 
 Gui::~Gui() {
-	SDL_DestroyTexture(this->backbuffer);
+	Graphics::ACCESS->destroyTarget(this->backbuffer);
 }
 
 void Gui::update(Milliseconds elapsedTime) {
@@ -711,6 +724,8 @@ void Gui::update(Milliseconds elapsedTime) {
 }
 
 void Gui::draw() const {
+	Graphics::ACCESS->queue->setLayer(RenderLayer::GUI); // non-overlay text also goes on top of the world
+
 	if (this->fade) { this->fade->draw(); }
 
 	this->inventoryGUI.draw(); // non-optional
@@ -819,23 +834,17 @@ void Gui::Fade_off() {
 
 
 void Gui::textureToGUI(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect) {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), this->backbuffer); // take target for rendering
-
-	SDL_RenderCopy(Graphics::ACCESS->getRenderer(), texture, sourceRect, destRect);
+	Graphics::ACCESS->queue->record(this->backbuffer, texture, sourceRect, destRect);
 }
 void Gui::textureToGUIEx(SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip) {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), this->backbuffer); // take target for rendering
-
-	SDL_RenderCopyEx(Graphics::ACCESS->getRenderer(), texture, sourceRect, destRect, angle, NULL, flip);
+	Graphics::ACCESS->queue->record(this->backbuffer, texture, sourceRect, destRect, angle, flip);
 }
 
 void Gui::GUIToRenderer() {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), NULL); // give target back to the renderer
+	Graphics::ACCESS->queue->submit(); // backbuffer must be complete
 
 	Graphics::ACCESS->copyTextureToRenderer(this->backbuffer, NULL, NULL);
 }
 void Gui::GUIClear() {
-	SDL_SetRenderTarget(Graphics::ACCESS->getRenderer(), this->backbuffer); // take target for rendering
-
-	SDL_RenderClear(Graphics::ACCESS->getRenderer());
+	Graphics::ACCESS->clearTarget(this->backbuffer); // take target for rendering
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "hitbox_grid.h"
+
+#include <algorithm> // 'std::sort()', 'std::unique()', 'std::min()', 'std::max()'
+
+
+
+// # HitboxGrid #
+void HitboxGrid::reset(const Rectangle &area, int cellSize) {
+	const Vector2 areaSize = area.getDimensions();
+
+	this->cell_size = cellSize;
+	this->grid_origin = Vector2(area.getSide(Side::LEFT), area.getSide(Side::TOP));
+	this->grid_size = Vector2(
+		std::max(1, (areaSize.x + cellSize - 1) / cellSize),
+		std::max(1, (areaSize.y + cellSize - 1) / cellSize)
+	);
+
+	this->rects.clear();
+	this->groups.clear();
+	this->group_count = 0;
+
+	this->cell_start.assign(this->grid_size.x * this->grid_size.y + 1, 0);
+	this->cell_items.clear();
+}
+
+void HitboxGrid::add(const std::vector<Rectangle> &rectangles) {
+	for (const auto &rect : rectangles) {
+		this->rects.push_back(rect);
+		this->groups.push_back(this->group_count);
+	}
+	++this->group_count;
+}
+
+void HitboxGrid::build() {
+	const size_t cellCount = this->cell_start.size() - 1;
+
+	// Count how many rectangles touch each cell
+	std::vector<size_t> counts(cellCount, 0);
+
+	for (const auto &rect : this->rects) {
+		for (int y = this->cell_y(rect.getSide(Side::TOP)); y <= this->cell_y(rect.getSide(Side::BOTTOM)); ++y)
+			for (int x = this->cell_x(rect.getSide(Side::LEFT)); x <= this->cell_x(rect.getSide(Side::RIGHT)); ++x)
+				++counts[y * this->grid_size.x + x];
+	}
+
+	// Turn counts into offsets
+	this->cell_start[0] = 0;
+	for (size_t i = 0; i < cellCount; ++i) { this->cell_start[i + 1] = this->cell_start[i] + counts[i]; }
+
+	// Fill cells, rectangles are visited in order so every cell ends up sorted
+	this->cell_items.resize(this->cell_start[cellCount]);
+	std::vector<size_t> cursor(this->cell_start.begin(), this->cell_start.end() - 1);
+
+	for (size_t i = 0; i < this->rects.size(); ++i) {
+		const Rectangle &rect = this->rects[i];
+
+		for (int y = this->cell_y(rect.getSide(Side::TOP)); y <= this->cell_y(rect.getSide(Side::BOTTOM)); ++y)
+			for (int x = this->cell_x(rect.getSide(Side::LEFT)); x <= this->cell_x(rect.getSide(Side::RIGHT)); ++x)
+				this->cell_items[cursor[y * this->grid_size.x + x]++] = i;
+	}
+}
+
+void HitboxGrid::query(const Rectangle &area, std::vector<size_t> &result) const {
+	result.clear();
+
+	if (this->rects.empty()) { return; }
+
+	const int left = this->cell_x(area.getSide(Side::LEFT));
+	const int right = this->cell_x(area.getSide(Side::RIGHT));
+	const int top = this->cell_y(area.getSide(Side::TOP));
+	const int bottom = this->cell_y(area.getSide(Side::BOTTOM));
+
+	for (int y = top; y <= bottom; ++y)
+		for (int x = left; x <= right; ++x) {
+			const size_t cell = y * this->grid_size.x + x;
+			result.insert(result.end(), this->cell_items.begin() + this->cell_start[cell], this->cell_items.begin() + this->cell_start[cell + 1]);
+		}
+
+	// Rectangles spanning multiple cells are found multiple times
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+// Getters
+const Rectangle& HitboxGrid::getRect(size_t index) const { return this->rects[index]; }
+size_t HitboxGrid::getGroup(size_t index) const { return this->groups[index]; }
+size_t HitboxGrid::size() const { return this->rects.size(); }
+
+// Internal
+int HitboxGrid::cell_x(int x) const {
+	x -= this->grid_origin.x;
+	const int cell = (x >= 0) ? (x / this->cell_size) : ((x + 1) / this->cell_size - 1); // floor division
+	return std::min(std::max(cell, 0), this->grid_size.x - 1);
+}
+int HitboxGrid::cell_y(int y) const {
+	y -= this->grid_origin.y;
+	const int cell = (y >= 0) ? (y / this->cell_size) : ((y + 1) / this->cell_size - 1); // floor division
+	return std::min(std::max(cell, 0), this->grid_size.y - 1);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector> // related type
+
+#include "geometry_utils.h" // geometry types
+
+
+
+// # HitboxGrid #
+// - Uniform grid broadphase for static hitboxes (aka tile hitboxes)
+// - Each cell holds indices of all rectangles that touch it (overlap check is inclusive, same as 'Rectangle')
+// - Rectangles are added in groups (one group per tile), indices follow order of insertion
+// - Usage: reset() -> add() for each tile -> build() -> query() as much as needed
+class HitboxGrid {
+public:
+	HitboxGrid() = default;
+
+	void reset(const Rectangle &area, int cellSize); // clears the grid, sets up cells covering given area (in pixels)
+
+	void add(const std::vector<Rectangle> &rectangles); // adds rectangles as a single group
+	void build(); // distributes added rectangles between cells, must be called before any queries
+
+	void query(const Rectangle &area, std::vector<size_t> &result) const;
+		// fills <result> with indices of all rectangles from cells <area> touches
+		// indices are sorted and unique, which preserves insertion order
+
+	// Getters
+	const Rectangle& getRect(size_t index) const;
+	size_t getGroup(size_t index) const; // returns group (aka tile) index of a rectangle
+	size_t size() const; // returns total number of rectangles
+
+private:
+	int cell_x(int x) const; // returns column of a cell containing given x, clamped to the grid
+	int cell_y(int y) const; // returns row of a cell containing given y, clamped to the grid
+
+	int cell_size = 1;
+	Vector2 grid_origin; // top-left corner of the covered area
+	Vector2 grid_size; // number of columns and rows
+
+	std::vector<Rectangle> rects;
+	std::vector<size_t> groups; // group index of every rectangle
+	size_t group_count = 0;
+
+	// Cell contents are stored in a single array, cell 'i' owns [cell_start[i], cell_start[i + 1])
+	std::vector<size_t> cell_start;
+	std::vector<size_t> cell_items;
+};
@@ -0,0 +1,268 @@
+// Left out of headless build, see 'graphics_headless.cpp'
+#ifndef HATMAN_HEADLESS
+
+#include "image_decoder.h"
+
+#include <SDL_image.h> // decoding of images
+#include <cstring> // 'std::memcpy()'
+#include <chrono> // 'std::chrono::seconds' type (checking future status)
+
+#include <fstream> // writing cache files
+#include <filesystem> // creation of cache folder, atomic file replacement
+#include <cstdio> // 'snprintf()'
+#include <thread> // 'std::this_thread::get_id()' (unique temporary files)
+
+#include "content_archive.h" // 'ContentFile' class
+#include "mapped_file.h" // 'MappedFile' class (reading cache)
+#include "level_data.h" // 'level_data::hash()'
+#include "job_system.h" // background decoding
+
+
+
+/* ### RAW FORMAT ### */
+
+// Layout (native byte order, cache is never moved between machines):
+// - header: magic, format version, width, height, encoding, payload size in bytes => 6 x uint32
+// - payload: either plain ARGB8888 pixels row by row,
+//   or RLE runs as (uint32 count, uint32 pixel) pairs, used when it's smaller (sprites are mostly transparent)
+
+namespace {
+	const uint32_t RAW_MAGIC = 0x58544D48; // "HMTX"
+	const uint32_t RAW_VERSION = 1; // increment upon any change to layout
+
+	const uint32_t ENCODING_PLAIN = 0;
+	const uint32_t ENCODING_RLE = 1;
+
+	const size_t HEADER_SIZE = 6 * sizeof(uint32_t);
+
+	void append_u32(std::string &buffer, uint32_t value) {
+		buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+}
+
+
+
+// # ImageDecoder #
+ImageDecoder::~ImageDecoder() {
+	this->cancel();
+}
+
+void ImageDecoder::request(SDL_Texture* target, const std::string &filePath) {
+	this->images.push_back({ target, ImageDecoder::decodeAsync(filePath) });
+}
+
+void ImageDecoder::upload() {
+	for (auto iter = this->images.begin(); iter != this->images.end();) {
+		if (iter->surface.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++iter;
+			continue;
+		}
+
+		if (SDL_Surface* surface = iter->surface.get()) {
+			SDL_UpdateTexture(iter->target, NULL, surface->pixels, surface->pitch);
+			SDL_FreeSurface(surface);
+		}
+
+		iter = this->images.erase(iter);
+	}
+}
+
+void ImageDecoder::cancel() {
+	for (auto &image : this->images) {
+		if (SDL_Surface* surface = image.surface.get()) { SDL_FreeSurface(surface); }
+	}
+
+	this->images.clear();
+}
+
+void ImageDecoder::cancel(SDL_Texture* target) {
+	for (auto iter = this->images.begin(); iter != this->images.end();) {
+		if (iter->target != target) {
+			++iter;
+			continue;
+		}
+
+		if (SDL_Surface* surface = iter->surface.get()) { SDL_FreeSurface(surface); }
+		iter = this->images.erase(iter);
+	}
+}
+
+size_t ImageDecoder::pending() const {
+	return this->images.size();
+}
+
+SDL_Surface* ImageDecoder::decode(const std::string &filePath) {
+	const ContentFile file(filePath);
+	if (!file.data()) { return nullptr; }
+
+	const std::string cachePath = ImageDecoder::getCachePath(level_data::hash(file.data(), file.size()));
+
+	// Cache is present => no need to decompress PNG
+	{
+		const MappedFile cache(cachePath);
+		if (cache.is_open()) {
+			if (SDL_Surface* surface = ImageDecoder::fromRaw(cache.data(), cache.size())) { return surface; }
+		}
+	}
+
+	// Cache is absent/outdated => decode and make a new cache
+	SDL_Surface* loadedSurface = IMG_Load_RW(SDL_RWFromConstMem(file.data(), static_cast<int>(file.size())), 1); // decodes straight from the mapping
+	if (!loadedSurface) { return nullptr; }
+
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(loadedSurface, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(loadedSurface);
+	if (!surface) { return nullptr; }
+
+	std::error_code error; // cache is optional, failing to write it is not an error
+	std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+	const std::string tempPath = cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+		// write + rename, so a partially written cache is never read, name is unique per thread since
+		// identical images (same hash) can be decoded by several workers at once
+	{
+		std::ofstream cacheFile(tempPath, std::ios::binary);
+		const std::string raw = ImageDecoder::toRaw(surface);
+		cacheFile.write(raw.data(), raw.size());
+	}
+	std::filesystem::rename(tempPath, cachePath, error);
+
+	return surface;
+}
+std::future<SDL_Surface*> ImageDecoder::decodeAsync(const std::string &filePath) {
+	return JobSystem::ACCESS->async([filePath]() { return ImageDecoder::decode(filePath); });
+}
+
+std::string ImageDecoder::toRaw(SDL_Surface* surface) {
+	const uint32_t width = static_cast<uint32_t>(surface->w);
+	const uint32_t height = static_cast<uint32_t>(surface->h);
+
+	SDL_LockSurface(surface);
+
+	// Plain pixels
+	std::string plain;
+	plain.reserve(static_cast<size_t>(width) * height * sizeof(uint32_t));
+	for (uint32_t y = 0; y < height; ++y) {
+		plain.append(static_cast<const char*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch, width * sizeof(uint32_t));
+	}
+
+	SDL_UnlockSurface(surface);
+
+	// RLE runs
+	std::string rle;
+	const size_t pixelCount = static_cast<size_t>(width) * height;
+	for (size_t i = 0; i < pixelCount && rle.size() < plain.size();) {
+		uint32_t pixel;
+		std::memcpy(&pixel, plain.data() + i * sizeof(uint32_t), sizeof(pixel));
+
+		uint32_t count = 1;
+		while (i + count < pixelCount && std::memcmp(&pixel, plain.data() + (i + count) * sizeof(uint32_t), sizeof(pixel)) == 0) { ++count; }
+
+		append_u32(rle, count);
+		append_u32(rle, pixel);
+		i += count;
+	}
+
+	const bool useRLE = (rle.size() < plain.size());
+	const std::string &payload = useRLE ? rle : plain;
+
+	std::string raw;
+	raw.reserve(HEADER_SIZE + payload.size());
+	append_u32(raw, RAW_MAGIC);
+	append_u32(raw, RAW_VERSION);
+	append_u32(raw, width);
+	append_u32(raw, height);
+	append_u32(raw, useRLE ? ENCODING_RLE : ENCODING_PLAIN);
+	append_u32(raw, static_cast<uint32_t>(payload.size()));
+	raw += payload;
+
+	return raw;
+}
+
+SDL_Surface* ImageDecoder::fromRaw(const char* bytes, size_t length) {
+	if (length < HEADER_SIZE) { return nullptr; }
+
+	uint32_t header[6];
+	std::memcpy(header, bytes, HEADER_SIZE);
+
+	const uint32_t width = header[2];
+	const uint32_t height = header[3];
+	const uint32_t encoding = header[4];
+	const size_t payloadSize = header[5];
+
+	if (header[0] != RAW_MAGIC || header[1] != RAW_VERSION) { return nullptr; }
+	if (!width || !height || width > 16384 || height > 16384) { return nullptr; }
+	if (payloadSize != length - HEADER_SIZE) { return nullptr; }
+
+	const char* payload = bytes + HEADER_SIZE;
+	const size_t pixelCount = static_cast<size_t>(width) * height;
+
+	if (encoding == ENCODING_PLAIN && payloadSize != pixelCount * sizeof(uint32_t)) { return nullptr; }
+	if (encoding != ENCODING_PLAIN && encoding != ENCODING_RLE) { return nullptr; }
+
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (!surface) { return nullptr; }
+
+	SDL_LockSurface(surface);
+
+	bool good = true;
+
+	if (encoding == ENCODING_PLAIN) { // straight copy
+		for (uint32_t y = 0; y < height; ++y) {
+			std::memcpy(static_cast<char*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch, payload + static_cast<size_t>(y) * width * sizeof(uint32_t), width * sizeof(uint32_t));
+		}
+	}
+	else {
+		size_t pixel = 0;
+		for (size_t offset = 0; offset + 2 * sizeof(uint32_t) <= payloadSize && good; offset += 2 * sizeof(uint32_t)) {
+			uint32_t run[2]; // count, value
+			std::memcpy(run, payload + offset, sizeof(run));
+
+			if (run[0] > pixelCount - pixel) { good = false; break; }
+
+			for (uint32_t k = 0; k < run[0]; ++k, ++pixel) {
+				uint32_t* row = reinterpret_cast<uint32_t*>(static_cast<char*>(surface->pixels) + (pixel / width) * surface->pitch);
+				row[pixel % width] = run[1];
+			}
+		}
+
+		if (pixel != pixelCount) { good = false; }
+	}
+
+	SDL_UnlockSurface(surface);
+
+	if (!good) {
+		SDL_FreeSurface(surface);
+		return nullptr;
+	}
+
+	return surface;
+}
+
+std::string ImageDecoder::getCachePath(uint64_t sourceHash) {
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(sourceHash));
+	return "temp/cache/textures/" + std::string(name) + ".raw";
+}
+
+bool ImageDecoder::readSize(const std::string &filePath, Vector2 &size) {
+	// PNG => [ 8 bytes signature | 4 bytes length | "IHDR" | 4 bytes width | 4 bytes height | ... ], big-endian
+	const ContentFile file(filePath);
+
+	unsigned char header[24];
+	if (file.size() < sizeof(header)) { return false; }
+	std::memcpy(header, file.data(), sizeof(header));
+
+	const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	for (int i = 0; i < 8; ++i) { if (header[i] != SIGNATURE[i]) return false; }
+	if (header[12] != 'I' || header[13] != 'H' || header[14] != 'D' || header[15] != 'R') { return false; }
+
+	const auto readBE = [&header](int offset) {
+		return (header[offset] << 24) | (header[offset + 1] << 16) | (header[offset + 2] << 8) | header[offset + 3];
+	};
+
+	size = Vector2(readBE(16), readBE(20));
+
+	return size.x > 0 && size.y > 0;
+}
+
+#endif // !HATMAN_HEADLESS
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL.h> // 'SDL_Texture', 'SDL_Surface' types
+#include <string> // related type
+#include <vector> // related type
+#include <future> // 'std::future' type (background decoding)
+#include <cstdint> // fixed-size types (raw format)
+
+#include "geometry_utils.h" // geometry types
+
+
+
+// # _pending_image #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Image that is being decoded in background
+struct _pending_image {
+	SDL_Texture* target; // placeholder texture that will receive decoded pixels
+	std::future<SDL_Surface*> surface;
+};
+
+
+
+// # ImageDecoder #
+// - Part of 'Graphics' module
+// - Decodes images on 'JobSystem' workers, only the upload of decoded pixels happens on the render thread
+// - Decoded pixels are uploaded into existing textures, so pointers and sizes of textures stay the same
+// and the texture is simply transparent until decoding finishes
+// - Decoded images are cached as raw ARGB8888 pixels (optionally RLE-compressed) at 'temp/cache/textures/',
+// named by the hash of the source file, so PNG decompression happens only once per image
+class ImageDecoder {
+public:
+	ImageDecoder() = default;
+
+	~ImageDecoder(); // waits for all background decodes to finish
+
+	void request(SDL_Texture* target, const std::string &filePath); // starts decoding, <target> should be ARGB8888 and of the same size as the image
+	void upload(); // uploads finished decodes to their textures, should be called once per frame on the render thread
+	void cancel(); // waits for all decodes and discards their results
+	void cancel(SDL_Texture* target); // same as above, but only for decodes targeting <target>
+
+	size_t pending() const; // number of unfinished decodes
+
+	static SDL_Surface* decode(const std::string &filePath); // loads image and converts it to ARGB8888, nullptr on failure, uses cache when possible
+	static std::future<SDL_Surface*> decodeAsync(const std::string &filePath);
+
+	static bool readSize(const std::string &filePath, Vector2 &size); // reads size from the PNG header, returns false for anything but PNG
+
+	static std::string toRaw(SDL_Surface* surface); // <surface> should be ARGB8888
+	static SDL_Surface* fromRaw(const char* bytes, size_t length); // returns nullptr if data is malformed or outdated
+
+	static std::string getCachePath(uint64_t sourceHash); // path to the raw image
+
+private:
+	std::vector<_pending_image> images;
+};
@@ -0,0 +1,36 @@
+#include "instance_context.h"
+
+#include "game.h" // instance storages
+#include "graphics.h"
+#include "emit.h"
+#include "saver.h"
+#include "controls.h"
+#include "solid.h"
+#include "timer.h"
+
+
+
+// # InstanceContext #
+InstanceContext InstanceContext::capture() {
+	InstanceContext context;
+
+	context.game = Game::ACCESS;
+	context.graphics = Graphics::ACCESS;
+	context.emits = EmitStorage::ACCESS;
+	context.saver = Saver::ACCESS;
+	context.controls = Controls::ACCESS;
+	context.solids = SolidStorage::ACCESS;
+	context.timers = TimerController::ACCESS;
+
+	return context;
+}
+
+void InstanceContext::bind() const {
+	Game::READ = Game::ACCESS = this->game;
+	Graphics::READ = Graphics::ACCESS = this->graphics;
+	EmitStorage::READ = EmitStorage::ACCESS = this->emits;
+	Saver::READ = Saver::ACCESS = this->saver;
+	Controls::READ = Controls::ACCESS = this->controls;
+	SolidStorage::READ = SolidStorage::ACCESS = this->solids;
+	TimerController::READ = TimerController::ACCESS = this->timers;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+
+
+class Game; // forward declare instance storages
+class Graphics;
+class EmitStorage;
+class Saver;
+class Controls;
+class SolidStorage;
+class TimerController;
+
+
+
+// # InstanceContext #
+// - Set of storages that belong to a single game instance
+// - Static 'READ' and 'ACCESS' fields of these storages are thread-local and storages set them upon creation,
+// so several instances can live in one process as long as each one is created on its own thread
+// - 'JobSystem' captures context of the thread that submits a job and binds it while the job runs,
+// so work of an instance sees its own storages on any worker
+// - 'JobSystem', 'ContentArchive' and 'TilesetStorage' are process-wide, tilesets are only read through
+// 'level.cpp' which serializes access to them, so instances share loaded tilesets
+struct InstanceContext {
+	static InstanceContext capture(); // returns storages bound to the current thread
+	void bind() const; // binds storages to the current thread
+
+	Game* game = nullptr;
+	Graphics* graphics = nullptr;
+	EmitStorage* emits = nullptr;
+	Saver* saver = nullptr;
+	Controls* controls = nullptr;
+	SolidStorage* solids = nullptr;
+	TimerController* timers = nullptr;
+};
@@ -0,0 +1,211 @@
+#include "job_system.h"
+
+#include <algorithm> // 'std::min()', 'std::max()'
+
+#include "effect_buffer.h" // jobs run without a bound buffer
+
+
+
+namespace {
+thread_local size_t workerIndex = SIZE_MAX; // index of the worker running on this thread, SIZE_MAX outside of the pool
+}
+
+
+
+// # JobSystem #
+const JobSystem* JobSystem::READ;
+JobSystem* JobSystem::ACCESS;
+
+JobSystem::JobSystem(size_t workerCount) :
+	stats_start(std::chrono::steady_clock::now())
+{
+	this->READ = this;
+	this->ACCESS = this;
+
+	if (!workerCount) { workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1; }
+	workerCount = std::max<size_t>(workerCount, 1); // at least one worker, so blocking on a future never deadlocks
+
+	for (size_t i = 0; i < workerCount; ++i) { this->workers.push_back(std::make_unique<_job_worker>()); }
+	for (size_t i = 0; i < workerCount; ++i) { this->workers[i]->thread = std::thread(&JobSystem::worker_Loop, this, i); }
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(this->sleep_mutex);
+		this->stopping = true;
+	}
+	this->sleep_condition.notify_all();
+
+	for (auto &worker : this->workers) { worker->thread.join(); }
+}
+
+JobHandle JobSystem::submit(std::function<void()> &&work, const std::vector<JobHandle> &dependencies) {
+	JobHandle job = std::make_shared<_job>();
+	job->work = std::move(work);
+	job->context = InstanceContext::capture();
+	job->unfinished_dependencies = dependencies.size() + 1; // extra one keeps the job from being queued while dependencies are registered
+
+	size_t finishedDependencies = 1;
+
+	for (const auto &dependency : dependencies) {
+		if (!dependency) { ++finishedDependencies; continue; }
+
+		std::lock_guard<std::mutex> lock(dependency->continuations_mutex);
+		if (dependency->done) { ++finishedDependencies; }
+		else { dependency->continuations.push_back(job); }
+	}
+
+	if (job->unfinished_dependencies.fetch_sub(finishedDependencies) == finishedDependencies) { this->push(job); }
+
+	return job;
+}
+
+void JobSystem::wait(const JobHandle &job) {
+	while (!this->finished(job)) {
+		if (JobHandle other = this->take()) { this->run(other); }
+		else { std::this_thread::yield(); }
+	}
+}
+
+bool JobSystem::finished(const JobHandle &job) const {
+	return !job || job->done;
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)> &body) {
+	grainSize = std::max<size_t>(grainSize, 1);
+
+	if (count <= grainSize) { // single range => no point in involving workers
+		if (count) { body(0, count); }
+		return;
+	}
+
+	std::vector<JobHandle> ranges;
+	for (size_t begin = grainSize; begin < count; begin += grainSize) {
+		const size_t end = std::min(count, begin + grainSize);
+		ranges.push_back(this->submit([&body, begin, end]() { body(begin, end); }));
+	}
+
+	body(0, grainSize); // caller takes the first range itself
+
+	for (const auto &range : ranges) { this->wait(range); }
+}
+
+size_t JobSystem::getWorkerCount() const {
+	return this->workers.size();
+}
+
+std::vector<WorkerStats> JobSystem::getStats() const {
+	const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->stats_start).count();
+
+	std::vector<WorkerStats> stats(this->workers.size());
+
+	for (size_t i = 0; i < this->workers.size(); ++i) {
+		stats[i].jobs_executed = this->workers[i]->jobs_executed;
+		stats[i].jobs_stolen = this->workers[i]->jobs_stolen;
+		stats[i].busy_time = this->workers[i]->busy_time / 1000.;
+		stats[i].utilization = elapsed > 0 ? std::min(1., stats[i].busy_time / elapsed) : 0;
+	}
+
+	return stats;
+}
+
+void JobSystem::resetStats() {
+	for (auto &worker : this->workers) {
+		worker->jobs_executed = 0;
+		worker->jobs_stolen = 0;
+		worker->busy_time = 0;
+	}
+
+	this->stats_start = std::chrono::steady_clock::now();
+}
+
+void JobSystem::worker_Loop(size_t index) {
+	workerIndex = index;
+
+	while (true) {
+		if (JobHandle job = this->take()) {
+			this->run(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->sleep_mutex);
+		if (this->stopping && !this->queued_jobs) { return; } // queued jobs are finished before stopping
+
+		this->sleep_condition.wait(lock, [this]() { return this->queued_jobs || this->stopping; });
+	}
+}
+
+void JobSystem::push(const JobHandle &job) {
+	// Workers push into their own queue (keeps related jobs on the same core), other threads spread jobs evenly
+	const size_t index = (workerIndex != SIZE_MAX) ? workerIndex : this->next_queue++ % this->workers.size();
+
+	{
+		std::lock_guard<std::mutex> lock(this->workers[index]->queue_mutex);
+		this->workers[index]->queue.push_back(job);
+	}
+
+	++this->queued_jobs;
+
+	{ std::lock_guard<std::mutex> lock(this->sleep_mutex); } // sleeping worker either sees the job or gets notified
+	this->sleep_condition.notify_one();
+}
+
+JobHandle JobSystem::take() {
+	const size_t count = this->workers.size();
+	const size_t own = (workerIndex != SIZE_MAX) ? workerIndex : 0;
+
+	for (size_t i = 0; i < count; ++i) {
+		const size_t index = (own + i) % count;
+		const bool stealing = (workerIndex == SIZE_MAX || index != workerIndex);
+
+		_job_worker &worker = *this->workers[index];
+		std::lock_guard<std::mutex> lock(worker.queue_mutex);
+		if (worker.queue.empty()) { continue; }
+
+		JobHandle job;
+		if (stealing) { job = std::move(worker.queue.front()); worker.queue.pop_front(); } // oldest job, likely the biggest one
+		else { job = std::move(worker.queue.back()); worker.queue.pop_back(); } // newest job, likely still in cache
+
+		--this->queued_jobs;
+
+		if (stealing && workerIndex != SIZE_MAX) { ++this->workers[workerIndex]->jobs_stolen; }
+
+		return job;
+	}
+
+	return nullptr;
+}
+
+void JobSystem::run(const JobHandle &job) {
+	const auto start = std::chrono::steady_clock::now();
+
+	const InstanceContext previousContext = InstanceContext::capture(); // job might run inside of 'wait()' of another instance
+	job->context.bind();
+
+	{
+		const EffectBuffer::Binding noBuffer(nullptr); // effects of the job don't leak into buffer of the job it runs inside of
+
+		job->work();
+		job->work = nullptr; // releases captured resources early
+	}
+
+	previousContext.bind();
+
+	if (workerIndex != SIZE_MAX) {
+		_job_worker &worker = *this->workers[workerIndex];
+		++worker.jobs_executed;
+		worker.busy_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Queue jobs that were waiting for this one
+	std::vector<JobHandle> continuations;
+	{
+		std::lock_guard<std::mutex> lock(job->continuations_mutex);
+		job->done = true;
+		continuations.swap(job->continuations);
+	}
+
+	for (const auto &continuation : continuations) {
+		if (--continuation->unfinished_dependencies == 0) { this->push(continuation); }
+	}
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <vector> // related type
+#include <deque> // related type (job queues)
+#include <memory> // 'shared_ptr' type (job handles)
+#include <functional> // 'std::function' type (job work)
+#include <future> // 'std::future', 'std::packaged_task' types (async jobs)
+#include <thread> // 'std::thread' type (workers)
+#include <mutex> // 'std::mutex' type (queues)
+#include <condition_variable> // waking up sleeping workers
+#include <atomic> // job counters, stats
+#include <chrono> // stats timing
+#include <cstdint> // fixed-size types (stats)
+
+#include "timer.h" // 'Milliseconds' type
+#include "instance_context.h" // 'InstanceContext' struct (jobs run in context of the instance that submitted them)
+
+
+
+struct _job;
+typedef std::shared_ptr<_job> JobHandle; // allows waiting for a job and using it as a dependency
+
+
+
+// # _job #
+// - NOT INTENDED FOR EXTERNAL USE!
+struct _job {
+	std::function<void()> work;
+	InstanceContext context; // storages of the instance that submitted the job
+
+	std::atomic<size_t> unfinished_dependencies{ 0 }; // job is queued once this reaches 0
+	std::atomic<bool> done{ false };
+
+	std::mutex continuations_mutex;
+	std::vector<JobHandle> continuations; // jobs that depend on this one
+};
+
+
+
+// # _job_worker #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Owner takes jobs from the back of its queue, other threads steal from the front
+struct _job_worker {
+	std::thread thread;
+
+	std::mutex queue_mutex;
+	std::deque<JobHandle> queue;
+
+	std::atomic<uint64_t> jobs_executed{ 0 };
+	std::atomic<uint64_t> jobs_stolen{ 0 };
+	std::atomic<uint64_t> busy_time{ 0 }; // in microseconds
+};
+
+
+
+// # WorkerStats #
+// - Utilization of a single worker since the last 'JobSystem::resetStats()'
+struct WorkerStats {
+	uint64_t jobs_executed = 0;
+	uint64_t jobs_stolen = 0; // executed jobs that were taken from queues of other workers
+	Milliseconds busy_time = 0;
+	double utilization = 0; // part of time spent running jobs, from 0 to 1
+};
+
+
+
+// # JobSystem #
+// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields
+// - Work-stealing thread pool shared by the whole game (level loading, physics, entity updates, image decoding, saving)
+// - Jobs can depend on other jobs, dependent job is queued once all of its dependencies finish
+// - Threads that wait for jobs ('wait()', 'parallelFor()') run queued jobs in the meantime
+// - Jobs shouldn't block on futures of other jobs, dependencies or 'wait()' should be used instead
+// - Pool is process-wide, jobs see storages of the instance that submitted them (see 'InstanceContext')
+class JobSystem {
+public:
+	JobSystem(size_t workerCount = 0); // 0 => one worker per hardware thread except for the main one
+
+	~JobSystem(); // finishes all queued jobs and stops workers
+
+	JobSystem(const JobSystem &other) = delete;
+	JobSystem& operator=(const JobSystem &other) = delete;
+
+	static const JobSystem* READ; // used for aka 'global' access
+	static JobSystem* ACCESS;
+
+	JobHandle submit(std::function<void()> &&work, const std::vector<JobHandle> &dependencies = {});
+		// queues <work> once all <dependencies> are finished, null handles are ignored
+
+	template<class Function>
+	auto async(Function &&function) -> std::future<decltype(function())> { // same as 'std::async()', but runs on the pool
+		using Result = decltype(function());
+
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+		std::future<Result> result = task->get_future();
+
+		this->submit([task]() { (*task)(); });
+
+		return result;
+	}
+
+	void wait(const JobHandle &job); // returns once <job> is finished, runs other jobs while waiting
+	bool finished(const JobHandle &job) const; // null handle counts as finished
+
+	void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)> &body);
+		// calls <body> for consecutive ranges of [0, count) that are at most <grainSize> long, returns once all ranges are done
+		// range boundaries don't depend on the number of workers
+
+	size_t getWorkerCount() const;
+
+	std::vector<WorkerStats> getStats() const; // main thread only, workers keep running since their counters are atomic
+	void resetStats(); // main thread only, same as above
+
+private:
+	void worker_Loop(size_t index);
+
+	void push(const JobHandle &job); // queues job that is ready to run
+	JobHandle take(); // takes job from own queue or steals one from another worker, nullptr if there are none
+	void run(const JobHandle &job); // executes job and queues its continuations
+
+	std::vector<std::unique_ptr<_job_worker>> workers;
+
+	std::atomic<size_t> queued_jobs{ 0 }; // jobs in all queues, workers sleep while there are none
+	std::atomic<size_t> next_queue{ 0 }; // jobs submitted from outside the pool are spread between workers
+	std::atomic<bool> stopping{ false };
+
+	std::mutex sleep_mutex;
+	std::condition_variable sleep_condition;
+
+	std::chrono::steady_clock::time_point stats_start;
+};
@@ -1,6 +1,10 @@
 #include "level.h"
 
-#include <fstream> // parsing from JSON (opening a file)
+#include <typeinfo> // 'typeid()' (telling interactive tiles from static ones)
+#include <algorithm> // 'std::min()', 'std::max()', 'std::find()'
+#include <unordered_set> // related type (logic gate emit inputs)
+#include <cstdlib> // 'std::abs()'
+#include <mutex> // 'std::mutex' type (tileset caches are shared by instances)
 
 #include "graphics.h" // access to rendering (background)
 #include "saver.h" // access to savefile info (level version)
@@ -8,538 +12,724 @@
 #include "tile_unique.h" // creation of unique tiles
 #include "entity_unique.h" // creation of unique entities
 #include "script_type.h" // creation of scripts
+#include "globalconsts.hpp" // tile size (hitbox grid)
+#include "nlohmann_external.hpp" // parsing tilesets (animated tiles)
+#include "content_archive.h" // reading tilesets (animated tiles)
+#include "job_system.h" // parallel entity updates
 
 
 
 
+namespace {
+// # _tileset_info #
+// - Properties of a tileset file that aren't exposed by 'Tileset'
+struct _tileset_info {
+	int tile_count = 0; // ids of the tileset are [0, tile_count)
+	std::unordered_set<int> animated_tiles; // ids of animated tiles
+};
+
+std::unordered_map<std::string, _tileset_info> tilesetInfos; // cleared by 'Level::forgetTilesets()'
+std::mutex tilesetsMutex; // guards 'tilesetInfos' and 'TilesetStorage', levels of different instances are built in parallel
+
+// Returns tile count and animated tiles of a tileset, each tileset file is parsed once
+// 'tilesetsMutex' should be held while the result is used
+const _tileset_info& get_TilesetInfo(const std::string &tilesetFileName) {
+	const auto iter = tilesetInfos.find(tilesetFileName);
+	if (iter != tilesetInfos.end()) { return iter->second; }
+
+	_tileset_info &result = tilesetInfos[tilesetFileName];
+
+	const ContentFile file("content/tilesets/" + tilesetFileName);
+	if (!file.data()) { return result; }
+
+	const nlohmann::json JSON = nlohmann::json::parse(file.data(), file.data() + file.size());
+
+	result.tile_count = JSON.value("tilecount", 0);
+
+	if (JSON.contains("tiles")) {
+		for (const auto &tile_node : JSON["tiles"]) {
+			if (tile_node.contains("animation")) { result.animated_tiles.insert(tile_node["id"].get<int>()); }
+		}
+	}
+
+	return result;
+}
+
+// Tiled stores flips in upper bits of gids, tiles have no flipped version, so flips are ignored
+int strip_Flags(int gid) {
+	const uint32_t FLIP_FLAGS = 0xE0000000; // horizontal, vertical and diagonal flips
+	return static_cast<int>(static_cast<uint32_t>(gid) & ~FLIP_FLAGS);
+}
+}
+
+
+
+// # _texture_deleter #
+void _texture_deleter::operator()(SDL_Texture* texture) const {
+	Graphics::ACCESS->destroyTarget(texture);
+}
+
+
+
 // # Level #
+const int CHUNK_SIZE_PIXELS = LevelData::CHUNK_SIZE * rendering::TILE_SIZE;
+
+const int CHUNK_ACTIVE_RADIUS = 1; // chunks within this radius (in chunks) of the player are updated and drawn
+const int CHUNK_LOAD_MARGIN = 1;
+	// loaded ring around active chunks, solids of an active chunk can move into the next chunk during a step
+	// and collide with its tiles, if that chunk wasn't loaded they would fall through it
+const int CHUNK_LOAD_RADIUS = CHUNK_ACTIVE_RADIUS + CHUNK_LOAD_MARGIN;
+const int CHUNK_UNLOAD_RADIUS = CHUNK_LOAD_RADIUS + 1; // more than load radius so chunks don't get reloaded when player walks along the border
+
 Level::Level(const std::string &mapName, const std::string &mapVersion) :
+	Level(mapName, mapVersion, level_data::load(tags::makeTag(mapName, mapVersion)))
+{}
+
+Level::Level(const std::string &mapName, const std::string &mapVersion, std::unique_ptr<Player> &&player) :
+	Level(mapName, mapVersion)
+{
+	this->initPlayer(std::move(player));
+}
+
+Level::Level(const std::string &mapName, const std::string &mapVersion, LevelData &&data) :
 	levelName(mapName),
 	levelVersion(mapVersion),
 	player(nullptr)
 {
-	this->loadLevel(tags::makeTag(mapName, mapVersion));
-	
+	this->build(std::move(data));
+
 	Graphics::ACCESS->gui->Fade_on(colors::BLACK, colors::BLACK.transparent(), 500);
 
 	Saver::ACCESS->record_Level(mapName, mapVersion);
 }
 
-Level::Level(const std::string &mapName, const std::string &mapVersion, std::unique_ptr<Player> &&player) :
-	Level(mapName, mapVersion)
+Level::Level(const std::string &mapName, const std::string &mapVersion, LevelData &&data, std::unique_ptr<Player> &&player) :
+	Level(mapName, mapVersion, std::move(data))
 {
 	this->initPlayer(std::move(player));
 }
 
 void Level::update(Milliseconds elapsedTime) {
-	for (auto &tile : this->tiles) { if (this->unfreezed(tile)) tile.update(elapsedTime); } // update all tiles
-	for (auto &entity : this->entities) { if (this->unfreezed(entity)) entity.update(elapsedTime); }
-	for (auto &script : this->scripts) { script.update(elapsedTime); }
+	// Remember state before the step for interpolation
+	for (auto &entity : this->entities) { entity.previous_position = entity.position; }
+	this->player->previous_position = this->player->position;
+
+	for (auto &chunk : this->chunks) {
+		if (!this->chunk_active(chunk.second.index)) { continue; }
+
+		for (auto &tile : chunk.second.tiles) { tile.update(elapsedTime); } // update interactive tiles
+		if (this->tileHitboxes_changed(chunk.second)) { this->rebuild_ChunkHitboxes(chunk.second); } // physics below sees current hitboxes
+		for (auto &tile : chunk.second.animated_tiles) { tile.update(elapsedTime); }
+		for (auto &script : chunk.second.scripts) { script.update(elapsedTime); }
+	}
+
+	// Physics of all active solids is resolved in a single pass, entities see the results during their updates
+	// Running it before entity updates keeps the old order: 'Entity::update()' used to move the solid first and
+	// derived updates (AI, player forms) applied forces afterwards, so forces of a step were always integrated on the next one
+	for (auto &entity : this->entities) { if (entity.solid && entity.enabled && this->unfreezed(entity)) entity.solid->activate(); }
+	if (this->player->solid && this->player->enabled) { this->player->solid->activate(); }
+	SolidRectangle::updateAll(elapsedTime);
 
-	this->player->update(elapsedTime);
+	Graphics::ACCESS->assets->pushScope(AssetScope::LEVEL); // textures of entities spawned by entities are released upon level change
+	this->update_Entities(elapsedTime);
+	Graphics::ACCESS->assets->popScope();
+
+	this->player->update(elapsedTime); // player touches input and GUI, so it's never updated in parallel with entities
 
 	this->clearDeadEntities();
 }
+void Level::stream() {
+	Graphics::ACCESS->assets->pushScope(AssetScope::LEVEL); // textures of entities spawned by streaming are released upon level change
+	this->update_Chunks();
+	Graphics::ACCESS->assets->popScope();
+}
 
 void Level::draw() const {
 	// Backround first
 	Graphics::ACCESS->copyTextureToRenderer(this->background, NULL, NULL); // background bypasses camera !!!
 
-	// Then tiles
-	for (const auto &tile : this->tiles) { if (this->unfreezed(tile)) tile.draw(); }
+	// Then static tiles (pre-rendered chunks first, animated tiles on top)
+	Graphics::ACCESS->queue->setLayer(RenderLayer::TILES, 0);
+
+	for (const auto &chunk : this->chunks) {
+		if (!chunk.second.baked_tiles || !this->chunk_active(chunk.second.index)) { continue; }
+
+		const SDL_Rect destRect = Rectangle(chunk.second.index * CHUNK_SIZE_PIXELS, Vector2(CHUNK_SIZE_PIXELS, CHUNK_SIZE_PIXELS)).toSDLRect();
+		Graphics::ACCESS->camera->textureToCamera(chunk.second.baked_tiles.get(), NULL, &destRect);
+	}
+
+	Graphics::ACCESS->queue->setLayer(RenderLayer::TILES, 1);
+
+	for (const auto &chunk : this->chunks) {
+		if (!this->chunk_active(chunk.second.index)) { continue; }
+		if (!Graphics::READ->camera->inView(Rectangle(chunk.second.index * CHUNK_SIZE_PIXELS, Vector2(CHUNK_SIZE_PIXELS, CHUNK_SIZE_PIXELS)))) { continue; }
+
+		for (const auto &tile : chunk.second.animated_tiles) { tile.draw(); }
+	}
+
+	// Then interactive tiles
+	Graphics::ACCESS->queue->setLayer(RenderLayer::TILES, 2);
+
+	for (const auto &chunk : this->chunks) {
+		if (!this->chunk_active(chunk.second.index)) { continue; }
+		if (!Graphics::READ->camera->inView(Rectangle(chunk.second.index * CHUNK_SIZE_PIXELS, Vector2(CHUNK_SIZE_PIXELS, CHUNK_SIZE_PIXELS)))) { continue; }
+
+		for (const auto &tile : chunk.second.tiles) { tile.draw(); }
+	}
 
 	// Then entities
+	Graphics::ACCESS->queue->setLayer(RenderLayer::ENTITIES);
+
 	for (const auto &entity : this->entities) { if (this->unfreezed(entity)) entity.draw(); }
 
+	Graphics::ACCESS->queue->setLayer(RenderLayer::PLAYER);
+
 	this->player->draw();
 }
 
+void Level::beginInterpolation(double alpha) {
+	this->simulated_positions.clear();
+
+	const auto interpolate = [&](Entity &entity) {
+		this->simulated_positions.push_back(entity.position);
+		entity.position = entity.previous_position + (entity.position - entity.previous_position) * alpha;
+	};
+
+	for (auto &entity : this->entities) { interpolate(entity); }
+	interpolate(*this->player);
+}
+void Level::endInterpolation() {
+	if (this->simulated_positions.empty()) { return; }
+
+	size_t i = 0;
+	for (auto &entity : this->entities) { entity.position = this->simulated_positions[i++]; }
+	this->player->position = this->simulated_positions[i];
+
+	this->simulated_positions.clear();
+}
+
 // Construction
 void Level::loadLevel(const std::string &mapName) {
-	this->parseFromJSON("content/levels/" + mapName + ".json");
+	this->build(level_data::load(mapName)); // uses precompiled binary when possible
 }
 
 void Level::initPlayer(std::unique_ptr<Player> &&player) {
 	this->player = std::move(player);
 }
 
+void Level::build(LevelData &&data) {
+	this->data = std::move(data);
 
-// Getters
-const Vector2& Level::getSize() const { return this->mapSize; }
-const std::string& Level::getName() const { return this->levelName; }
-const std::string& Level::getVersion() const { return this->levelVersion; }
+	Graphics::ACCESS->prefetchTextures(this->data.textures); // everything starts decoding in parallel
 
-// Internal
-void Level::clearDeadEntities() {
-	for (auto iter = this->entities.begin(); iter != this->entities.end();) {
-		if (iter->marked_for_erase()) {
-			this->entities.erase(iter++);
-		}
-		else {
-			++iter;
-		}
+	// Map properties
+	if (!this->data.background.empty()) {
+		Graphics::ACCESS->assets->pushScope(AssetScope::LEVEL); // released upon level change
+		this->background = Graphics::ACCESS->getTexture_Background(this->data.background);
+		Graphics::ACCESS->assets->popScope();
 	}
-}
 
-void Level::add_Tile(Tileset &tileset, int id, const Vector2 position) {
-	this->tiles.insert(tiles::make_tile(tileset, id, position));
-}
-void Level::add_Entity(const std::string &type, const std::string &name, Vector2d position) {
-	this->entities.insert(entities::make_entity(type, name, position));
-}
+	// Tilesets
+	for (const auto &tilesetRef : this->data.tilesets) {
+		std::unique_lock<std::mutex> lock(tilesetsMutex);
+		Tileset tileset = TilesetStorage::ACCESS->getTileset(tilesetRef.fileName);
+		lock.unlock();
 
-// Utility
-const int UNFREEZE_DISTANCE_TILE = 600 * 600; // square of distance where objects are unfreezed
-const int UNFREEZE_DISTANCE_ENTITY = 400 * 400; // less than for tiles to prevent objects falling through terrain
+		tileset.firstGid = tilesetRef.firstGid; // firstgid is map-dependant (that's also why we copy tilesets)
 
-bool Level::unfreezed(const Tile& tile) const {
-	return (this->player->position - tile.position).length2_rough() < UNFREEZE_DISTANCE_TILE;
-}
-bool Level::unfreezed(const Entity& entity) const {
-	return (this->player->position - entity.position).length2_rough() < UNFREEZE_DISTANCE_ENTITY;
-}
+		this->tilesets[tilesetRef.fileName] = std::move(tileset);
+	}
 
-void Level::damageInArea(const Rectangle &area, const Damage &damage) {
-	// Look for entities that should be damaged
-	for (auto &entity : this->entities) {
-		// Deal damage if entity has health+hitbox, is in the area, and of the enemy faction
-		if (entity.health && entity.solid && area.overlapsWithRect(entity.solid->getHitbox())) {
-			entity.health->applyDamage(damage);
-		}
+	// Assign tiles, entities and scripts to chunks
+	for (size_t i = 0; i < this->data.chunks.size(); ++i) {
+		this->chunk_tiles[chunk_key(this->data.chunks[i].index)] = i;
 	}
 
-	// Check the same for player
-	if (area.overlapsWithRect(this->player->solid->getHitbox())) {
-		this->player->health->applyDamage(damage);
+	for (size_t i = 0; i < this->data.entities.size(); ++i) {
+		this->chunk_entities[chunk_key(this->chunk_of(this->data.entities[i].position))].push_back(i);
+	}
+	this->spawn_states.assign(this->data.entities.size(), SpawnState::PENDING);
+
+	for (size_t i = 0; i < this->data.scripts.size(); ++i) {
+		const LevelData::ScriptDef &script = this->data.scripts[i];
+
+		this->chunk_scripts[chunk_key(this->chunk_of(script.hitbox.getCenter()))].push_back(i);
+
+		// Level changes tell which levels can be preloaded
+		if (script.type == LevelData::ScriptType::LEVEL_CHANGE || script.type == LevelData::ScriptType::LEVEL_SWITCH) {
+			if (std::find(this->neighbor_levels.begin(), this->neighbor_levels.end(), script.goes_to_level) == this->neighbor_levels.end()) {
+				this->neighbor_levels.push_back(script.goes_to_level);
+			}
+		}
 	}
 }
 
 
-// Parsing
-void Level::parseFromJSON(const std::string &filePath) {
-	// Load JSON doc
-	std::ifstream ifStream(filePath);
-	nlohmann::json JSON = nlohmann::json::parse(ifStream);
+void Level::forgetTilesets() {
+	std::lock_guard<std::mutex> lock(tilesetsMutex);
+	tilesetInfos.clear();
+}
 
-	// Parse map properties
-	for (const auto &property_node : JSON["properties"]) {
-		const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+// Getters
+const Vector2& Level::getSize() const { return this->data.mapSize; }
+const Vector2& Level::getOrigin() const { return this->data.origin; }
+const std::string& Level::getName() const { return this->levelName; }
+const std::string& Level::getVersion() const { return this->levelVersion; }
+const std::vector<std::string>& Level::getNeighbors() const { return this->neighbor_levels; }
 
-		if (prefix == "background") {
-			this->background = Graphics::ACCESS->getTexture_Background(property_node["value"].get<std::string>());
+void Level::getHitboxGrids(const Rectangle &area, std::vector<const HitboxGrid*> &result) const {
+	result.clear();
+
+	// Tile hitboxes may stick out of their chunk by up to a tile
+	const Vector2 topLeft = this->chunk_of(Vector2(area.getSide(Side::LEFT), area.getSide(Side::TOP)) - Vector2(rendering::TILE_SIZE, rendering::TILE_SIZE));
+	const Vector2 bottomRight = this->chunk_of(Vector2(area.getSide(Side::RIGHT), area.getSide(Side::BOTTOM)) + Vector2(rendering::TILE_SIZE, rendering::TILE_SIZE));
+
+	for (int y = topLeft.y; y <= bottomRight.y; ++y)
+		for (int x = topLeft.x; x <= bottomRight.x; ++x) {
+			const auto chunk = this->chunks.find(chunk_key(Vector2(x, y)));
+			if (chunk != this->chunks.end()) { result.push_back(&chunk->second.hitbox_grid); }
 		}
-		// new properties go there
+}
+
+// Modification
+bool Level::setTile(int layer, const Vector2 &tilePosition, int gid) {
+	if (layer < 0 || layer >= this->data.layerCount) { return false; }
+	if (tilePosition.x < 0 || tilePosition.y < 0 || tilePosition.x >= this->data.mapSize.x || tilePosition.y >= this->data.mapSize.y) { return false; }
+	if (gid) {
+		const _tile_kind &kind = this->get_TileKind(gid);
+		if (!kind.valid || kind.interactive) { return false; } // unknown gids can't be placed either
 	}
 
-	// Parse tilesets
-	const nlohmann::json &tilesets_array_node = JSON["tilesets"];
-	for (const auto &tileset_node : tilesets_array_node) {
-		// Extract tileset file name
-		std::string fileName = tileset_node["source"].get<std::string>();
-		fileName = fileName.substr(fileName.rfind("/") + 1); // cut before '/'
-		fileName = fileName.substr(fileName.rfind("\\") + 1); // cut before '\'
+	const Vector2 index(tilePosition.x / LevelData::CHUNK_SIZE, tilePosition.y / LevelData::CHUNK_SIZE);
+	const int64_t key = chunk_key(index);
 
-		Tileset tileset = TilesetStorage::ACCESS->getTileset(fileName);
-		tileset.firstGid = tileset_node["firstgid"].get<int>(); // firstgid is map-dependant (that's also why we copy tilesets)
+	// Find tile chunk in level description, create it if necessary
+	auto tiles = this->chunk_tiles.find(key);
+	if (tiles == this->chunk_tiles.end()) {
+		if (!gid) { return true; } // nothing to remove
 
-		this->tilesets[fileName] = std::move(tileset);
+		LevelData::TileChunk tileChunk;
+		tileChunk.index = index;
+		tileChunk.layers.assign(this->data.layerCount, std::vector<int>(LevelData::CHUNK_SIZE * LevelData::CHUNK_SIZE, 0));
+
+		this->data.chunks.push_back(std::move(tileChunk));
+		tiles = this->chunk_tiles.emplace(key, this->data.chunks.size() - 1).first;
 	}
 
-	// Parse map properties (size and etc)
-	this->mapSize.x = JSON["width"].get<int>();
-	this->mapSize.y = JSON["height"].get<int>();
+	int &tile = this->data.editLayer(tiles->second, layer)[(tilePosition.y % LevelData::CHUNK_SIZE) * LevelData::CHUNK_SIZE + tilePosition.x % LevelData::CHUNK_SIZE];
+	if (tile && this->get_TileKind(tile).interactive) { return false; }
 
-	// Parse tile layers
-	const nlohmann::json &layers_array_node = JSON["layers"];
-	for (const auto &layer_node : layers_array_node) {
-		const std::string layer_type = layer_node["type"].get<std::string>(); // can be "tilelayer" or "objectgroup"
+	tile = gid;
 
-		// Parse data depending on layer_type
-		if (layer_type == "tilelayer") {
-			this->parse_tilelayer(layer_node);
-		}
-		else if (layer_type == "objectgroup") {
-			this->parse_objectgroup(layer_node);
-		}
+	// Only the affected chunk is rebuilt (upon next update)
+	const auto chunk = this->chunks.find(key);
+	if (chunk != this->chunks.end()) {
+		chunk->second.source = static_cast<int>(tiles->second);
+		chunk->second.dirty = true;
 	}
 
+	return true;
 }
 
-void Level::parse_tilelayer(const nlohmann::json &tilelayer_node) {
-	int tileCount = 0; // used to determine tile position
-
-	const nlohmann::json &data_array_node = tilelayer_node["data"];
-	for (const auto &data_node : data_array_node) {
-		const int gid = data_node.get<int>();
-		if (gid) { // if tile is present
-			// Calculate tile position
-			const Vector2 tilePosition(
-				(tileCount % this->mapSize.x) * 32,
-				(tileCount / this->mapSize.x) * 32
-			);
+// Internal
+void Level::update_Entities(Milliseconds elapsedTime) {
+	this->active_entities.clear();
+	for (auto &entity : this->entities) { if (this->unfreezed(entity)) this->active_entities.push_back(&entity); }
 
-			// Determine which tileset tile belongs to (based on gid)
-			std::string correspondingTileset;
-			for (auto const &tileset : this->tilesets) {
-				if (gid >= tileset.second.firstGid) { correspondingTileset = tileset.second.getFileName(); }
-			}
+	// Tasks have fixed size and own buffers, so effects are applied in the same order regardless of thread count
+	const size_t taskCount = (this->active_entities.size() + ENTITIES_PER_TASK - 1) / ENTITIES_PER_TASK;
+	if (this->effect_buffers.size() < taskCount) { this->effect_buffers.resize(taskCount); }
 
-			const int tileId = gid - this->tilesets.at(correspondingTileset).firstGid;
+	JobSystem::ACCESS->parallelFor(this->active_entities.size(), ENTITIES_PER_TASK, [&](size_t begin, size_t end) {
+		const EffectBuffer::Binding binding(&this->effect_buffers[begin / ENTITIES_PER_TASK]);
 
-			// Construct tile and add it to the level
-			Tileset &tileTileset = this->tilesets.at(correspondingTileset);
+		for (size_t i = begin; i < end; ++i) { this->active_entities[i]->update(elapsedTime); }
+	});
 
-			// Add a tile based on its interactive_type (if present)
-			this->add_Tile(tileTileset, tileId, tilePosition);
-		}
-		++tileCount;
-	}
+	// Merge
+	for (size_t task = 0; task < taskCount; ++task) { this->effect_buffers[task].apply(); }
 }
 
-void Level::parse_objectgroup(const nlohmann::json &objectgroup_node) {
-	// get layer prefix and suffix
-	const std::string layer_prefix = tags::getPrefix(objectgroup_node["name"].get<std::string>());
-	const std::string layer_suffix = tags::getSuffix(objectgroup_node["name"].get<std::string>());
+void Level::clearDeadEntities() {
+	for (auto iter = this->entities.begin(); iter != this->entities.end();) {
+		if (iter->marked_for_erase()) {
+			const auto spawn = this->spawned_entities.find(&(*iter));
+			if (spawn != this->spawned_entities.end()) {
+				this->spawn_states[spawn->second] = SpawnState::DEAD; // killed entities don't respawn
+				this->spawned_entities.erase(spawn);
+			}
 
-	if (layer_prefix == "entity") {
-		this->parse_objectgroup_entity(objectgroup_node);
-	}
-	else if (layer_prefix == "script") {
-		if (layer_suffix == "level_change") {
-			this->parse_objectgroup_script_levelChange(objectgroup_node);
-		}
-		else if (layer_suffix == "level_switch") {
-			this->parse_objectgroup_script_levelSwitch(objectgroup_node);
-		}
-		else if (layer_suffix == "player_in_area") {
-			this->parse_objectgroup_script_PlayerInArea(objectgroup_node);
-		}
-		else if (layer_suffix == "AND") {
-			this->parse_objectgroup_script_AND(objectgroup_node);
+			iter = this->entities.erase(iter); // last entity takes its place
 		}
-		else if (layer_suffix == "OR") {
-			this->parse_objectgroup_script_OR(objectgroup_node);
-		}
-		else if (layer_suffix == "XOR") {
-			this->parse_objectgroup_script_XOR(objectgroup_node);
-		}
-		else if (layer_suffix == "NAND") {
-			this->parse_objectgroup_script_NAND(objectgroup_node);
-		}
-		else if (layer_suffix == "NOR") {
-			this->parse_objectgroup_script_NOR(objectgroup_node);
-		}
-		else if (layer_suffix == "XNOR") {
-			this->parse_objectgroup_script_XNOR(objectgroup_node);
+		else {
+			++iter;
 		}
-		// new script types go there
 	}
 }
 
-// Entity types parsing
-void Level::parse_objectgroup_entity(const nlohmann::json &objectgroup_node) {
-	const std::string entity_type = tags::getSuffix(objectgroup_node["name"].get<std::string>());
-
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
-		// Parse position
-		const Vector2 entityPosition(
-			object_node["x"].get<int>(),
-			object_node["y"].get<int>()
-		);
+void Level::update_Chunks() {
+	this->player_chunk = this->chunk_of(this->player->position.toVector2());
+
+	// Chunks in camera view are kept loaded as well
+	const Rectangle view = Graphics::ACCESS->camera->getFOV_Rect();
+	const Vector2 viewTopLeft = this->chunk_of(Vector2(view.getSide(Side::LEFT), view.getSide(Side::TOP)));
+	const Vector2 viewBottomRight = this->chunk_of(Vector2(view.getSide(Side::RIGHT), view.getSide(Side::BOTTOM)));
+
+	const auto inView = [&](const Vector2 &index) {
+		return viewTopLeft.x <= index.x && index.x <= viewBottomRight.x && viewTopLeft.y <= index.y && index.y <= viewBottomRight.y;
+	};
+	const auto inRadius = [&](const Vector2 &index, int radius) {
+		return std::abs(index.x - this->player_chunk.x) <= radius && std::abs(index.y - this->player_chunk.y) <= radius;
+	};
+
+	// Unload distant chunks
+	std::vector<Vector2> distant;
+	for (const auto &chunk : this->chunks) {
+		if (!inRadius(chunk.second.index, CHUNK_UNLOAD_RADIUS) && !inView(chunk.second.index)) { distant.push_back(chunk.second.index); }
+	}
+	for (const auto &index : distant) { this->unload_Chunk(index); }
 
-		// Parse custom properties
-		std::string entityName;
+	// Load nearby chunks (chunks outside of the map are never loaded)
+	const Vector2 chunkCount = (this->data.mapSize + Vector2(LevelData::CHUNK_SIZE - 1, LevelData::CHUNK_SIZE - 1)) / LevelData::CHUNK_SIZE;
 
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+	const int left = std::max(std::min(this->player_chunk.x - CHUNK_LOAD_RADIUS, viewTopLeft.x), 0);
+	const int right = std::min(std::max(this->player_chunk.x + CHUNK_LOAD_RADIUS, viewBottomRight.x), chunkCount.x - 1);
+	const int top = std::max(std::min(this->player_chunk.y - CHUNK_LOAD_RADIUS, viewTopLeft.y), 0);
+	const int bottom = std::min(std::max(this->player_chunk.y + CHUNK_LOAD_RADIUS, viewBottomRight.y), chunkCount.y - 1);
 
-			if (prefix == "name") {
-				entityName = property_node["value"].get<std::string>();
-			}
+	for (int y = top; y <= bottom; ++y)
+		for (int x = left; x <= right; ++x) {
+			const Vector2 index(x, y);
+			if ((inRadius(index, CHUNK_LOAD_RADIUS) || inView(index)) && !this->chunks.count(chunk_key(index))) { this->load_Chunk(index); }
 		}
 
-		this->add_Entity(entity_type, entityName, entityPosition);
-	}
+	// Rebuild chunks with modified tiles
+	for (auto &chunk : this->chunks) { if (chunk.second.dirty) this->rebuild_Chunk(chunk.second); }
 }
 
-// Scripts parsing
-void Level::parse_objectgroup_script_levelChange(const nlohmann::json &objectgroup_node) {
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
-		// Parse hitbox
-		const Rectangle hitbox = Rectangle(
-			object_node["x"].get<int>(), object_node["y"].get<int>(),
-			object_node["width"].get<int>(), object_node["height"].get<int>()
-		);
+void Level::load_Chunk(const Vector2 &index) {
+	const int64_t key = chunk_key(index);
 
-		std::string goes_to_level;
-		Vector2 goes_to_pos;
+	_level_chunk &chunk = this->chunks[key];
+	chunk.index = index;
 
-		// Parse custom properties
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+	// Interactive tiles (static ones are handled by 'rebuild_Chunk()')
+	const Vector2 chunkCorner = index * CHUNK_SIZE_PIXELS;
 
-			if (prefix == "goes_to_level") {
-				goes_to_level = property_node["value"].get<std::string>();
-			}
-			else if (prefix == "goes_to_x") {
-				goes_to_pos.x = property_node["value"].get<int>();
-			}
-			else if (prefix == "goes_to_y") {
-				goes_to_pos.y = property_node["value"].get<int>();
+	const auto tiles = this->chunk_tiles.find(key);
+	if (tiles != this->chunk_tiles.end()) {
+		chunk.source = static_cast<int>(tiles->second);
+
+		for (int layerIndex = 0; layerIndex < this->data.layerCount; ++layerIndex) {
+			const int* layer = this->data.getLayer(chunk.source, layerIndex); // tiles are read from level binary upon first access
+
+			for (int i = 0; i < LevelData::CHUNK_SIZE * LevelData::CHUNK_SIZE; ++i) {
+				if (!layer[i] || !this->get_TileKind(layer[i]).interactive) { continue; }
+
+				const Vector2 tilePosition = chunkCorner + Vector2(i % LevelData::CHUNK_SIZE, i / LevelData::CHUNK_SIZE) * rendering::TILE_SIZE;
+
+				this->add_Tile(chunk.tiles, layer[i], tilePosition);
 			}
 		}
+	}
+
+	this->rebuild_Chunk(chunk);
 
-		this->scripts.insert(std::make_unique<scripts::LevelChange>(hitbox, goes_to_level, goes_to_pos));
+	// Scripts
+	const auto scripts = this->chunk_scripts.find(key);
+	if (scripts != this->chunk_scripts.end()) {
+		for (const auto scriptIndex : scripts->second) { this->add_Script(chunk, this->data.scripts[scriptIndex]); }
+	}
+
+	// Entities
+	const auto entities = this->chunk_entities.find(key);
+	if (entities != this->chunk_entities.end()) {
+		for (const auto spawnIndex : entities->second) {
+			if (this->spawn_states[spawnIndex] == SpawnState::PENDING) { this->add_Entity(spawnIndex); }
+		}
 	}
 }
-void Level::parse_objectgroup_script_levelSwitch(const nlohmann::json &objectgroup_node) {
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
-		// Parse hitbox
-		const Rectangle hitbox = Rectangle(
-			object_node["x"].get<int>(), object_node["y"].get<int>(),
-			object_node["width"].get<int>(), object_node["height"].get<int>()
-		);
 
-		std::string goes_to_level;
-		Vector2 goes_to_pos;
+void Level::rebuild_Chunk(_level_chunk &chunk) {
+	const Vector2 chunkCorner = chunk.index * CHUNK_SIZE_PIXELS;
 
-		std::string emit_output = ""; // optional
-		int emit_output_lifetime = 0; // optional
+	this->rebuild_ChunkHitboxes(chunk);
 
-		// Parse custom properties
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+	// Animated tiles
+	chunk.animated_tiles = Collection<Tile>(); // animations restart, which is fine since chunk was just loaded or edited
 
-			if (prefix == "goes_to_level") {
-				goes_to_level = property_node["value"].get<std::string>();
-			}
-			else if (prefix == "goes_to_x") {
-				goes_to_pos.x = property_node["value"].get<int>();
-			}
-			else if (prefix == "goes_to_y") {
-				goes_to_pos.y = property_node["value"].get<int>();
-			}
-		}
+	bool hasBakedTiles = false;
 
-		this->scripts.insert(std::make_unique<scripts::LevelSwitch>(hitbox, goes_to_level, goes_to_pos));
-	}
-}
-void Level::parse_objectgroup_script_PlayerInArea(const nlohmann::json &objectgroup_node) {
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
-		// Parse hitbox
-		const Rectangle hitbox = Rectangle(
-			object_node["x"].get<int>(), object_node["y"].get<int>(),
-			object_node["width"].get<int>(), object_node["height"].get<int>()
-		);
+	if (chunk.source != -1) {
+		for (int layerIndex = 0; layerIndex < this->data.layerCount; ++layerIndex) {
+			const int* layer = this->data.getLayer(chunk.source, layerIndex);
 
-		std::string emit_output = ""; // optional
-		int emit_output_lifetime = 0; // optional
+			for (int i = 0; i < LevelData::CHUNK_SIZE * LevelData::CHUNK_SIZE; ++i) {
+				if (!layer[i]) { continue; } // no tile present
 
-		// Parse custom properties
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+				const _tile_kind &kind = this->get_TileKind(layer[i]);
+				if (!kind.valid || kind.interactive) { continue; } // tiles with unknown gids are skipped
 
-			if (prefix == "emit_output") {
-				emit_output = property_node["value"].get<std::string>();
-			}
-			else if (prefix == "emit_output_lifetime") {
-				emit_output_lifetime = property_node["value"].get<int>();
+				const Vector2 tilePosition = chunkCorner + Vector2(i % LevelData::CHUNK_SIZE, i / LevelData::CHUNK_SIZE) * rendering::TILE_SIZE;
+
+				if (kind.animated) { this->add_Tile(chunk.animated_tiles, layer[i], tilePosition); }
+				else { hasBakedTiles = true; }
 			}
 		}
+	}
 
-		auto script = std::make_unique<scripts::PlayerInArea>(hitbox);
-		script->setOutput(emit_output, emit_output_lifetime);
+	chunk.dirty = false;
 
-		this->scripts.insert(std::move(script));
+	// Pre-rendered texture
+	if (!hasBakedTiles || Graphics::HEADLESS) { // headless build never draws
+		chunk.baked_tiles.reset();
+		return;
 	}
-}
-void Level::parse_objectgroup_script_AND(const nlohmann::json &objectgroup_node) {
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
 
-		std::string emit_output = ""; // optional
-		int emit_output_lifetime = 0; // optional
+	if (!chunk.baked_tiles) {
+		chunk.baked_tiles.reset(Graphics::ACCESS->createTarget(Vector2(CHUNK_SIZE_PIXELS, CHUNK_SIZE_PIXELS))); // chunk texture has transparent parts
+	}
 
-		std::unordered_set<std::string> emit_inputs;
+	Graphics::ACCESS->camera->beginCapture(chunk.baked_tiles.get(), chunkCorner);
 
-		// Parse custom properties
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+	for (int layerIndex = 0; layerIndex < this->data.layerCount; ++layerIndex) {
+		const int* layer = this->data.getLayer(chunk.source, layerIndex);
 
-			if (prefix == "emit_output") {
-				emit_output = property_node["value"].get<std::string>();
-			}
-			else if (prefix == "emit_output_lifetime") {
-				emit_output_lifetime = property_node["value"].get<int>();
-			}
-			else if (prefix == "emit_input") {
-				// we don't care about suffix in this case, we only care about having duplicates-by-prefix
-				emit_inputs.insert(property_node["value"].get<std::string>());
-			}
-		}
+		for (int i = 0; i < LevelData::CHUNK_SIZE * LevelData::CHUNK_SIZE; ++i) {
+			if (!layer[i]) { continue; } // no tile present
 
-		auto script = std::make_unique<scripts::AND>(emit_inputs);
-		script->setOutput(emit_output, emit_output_lifetime);
+			const _tile_kind &kind = this->get_TileKind(layer[i]);
+			if (!kind.valid || kind.interactive || kind.animated) { continue; }
 
-		this->scripts.insert(std::move(script));
+			Graphics::ACCESS->camera->setDrawOffset(chunkCorner + Vector2(i % LevelData::CHUNK_SIZE, i / LevelData::CHUNK_SIZE) * rendering::TILE_SIZE);
+			kind.prototype->draw(); // prototype stays at (0, 0), so it can't be drawn to a wrong place by anyone else
+		}
 	}
+
+	Graphics::ACCESS->camera->setDrawOffset(Vector2());
+
+	Graphics::ACCESS->camera->endCapture();
 }
-void Level::parse_objectgroup_script_OR(const nlohmann::json &objectgroup_node) {
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
 
-		std::string emit_output = ""; // optional
-		int emit_output_lifetime = 0; // optional
+void Level::rebuild_ChunkHitboxes(_level_chunk &chunk) {
+	const Vector2 chunkCorner = chunk.index * CHUNK_SIZE_PIXELS;
 
-		std::unordered_set<std::string> emit_inputs;
+	chunk.hitbox_grid.reset(Rectangle(chunkCorner, Vector2(CHUNK_SIZE_PIXELS, CHUNK_SIZE_PIXELS)), rendering::TILE_SIZE);
 
-		// Parse custom properties
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+	// Interactive tiles go first, their hitboxes are remembered to notice when they change
+	chunk.tile_hitboxes.clear();
+	for (const auto &tile : chunk.tiles) {
+		chunk.tile_hitboxes.push_back(tile.hitbox ? tile.hitbox->rectangles : std::vector<Rectangle>());
+		chunk.hitbox_grid.add(chunk.tile_hitboxes.back());
+	}
 
-			if (prefix == "emit_output") {
-				emit_output = property_node["value"].get<std::string>();
-			}
-			else if (prefix == "emit_output_lifetime") {
-				emit_output_lifetime = property_node["value"].get<int>();
-			}
-			else if (prefix == "emit_input") {
-				// we don't care about suffix in this case, we only care about having duplicates-by-prefix
-				emit_inputs.insert(property_node["value"].get<std::string>());
+	if (chunk.source != -1) {
+		for (int layerIndex = 0; layerIndex < this->data.layerCount; ++layerIndex) {
+			const int* layer = this->data.getLayer(chunk.source, layerIndex);
+
+			for (int i = 0; i < LevelData::CHUNK_SIZE * LevelData::CHUNK_SIZE; ++i) {
+				if (!layer[i]) { continue; } // no tile present
+
+				const _tile_kind &kind = this->get_TileKind(layer[i]);
+				if (!kind.valid || kind.interactive || !kind.prototype->hitbox) { continue; }
+
+				// Static tiles are only present as gids in level description, hitbox is copied from prototype
+				const Vector2 tilePosition = chunkCorner + Vector2(i % LevelData::CHUNK_SIZE, i / LevelData::CHUNK_SIZE) * rendering::TILE_SIZE;
+
+				std::vector<Rectangle> hitbox = kind.prototype->hitbox->rectangles;
+				for (auto &rect : hitbox) { rect.moveBy(tilePosition); }
+
+				chunk.hitbox_grid.add(hitbox);
 			}
 		}
+	}
 
-		auto script = std::make_unique<scripts::OR>(emit_inputs);
-		script->setOutput(emit_output, emit_output_lifetime);
+	chunk.hitbox_grid.build(); // all tiles are present => distribute hitboxes between cells
+}
+bool Level::tileHitboxes_changed(const _level_chunk &chunk) const {
+	if (chunk.tiles.size() != chunk.tile_hitboxes.size()) { return true; }
 
-		this->scripts.insert(std::move(script));
+	const auto sameRect = [](const Rectangle &a, const Rectangle &b) {
+		return a.getCorner().x == b.getCorner().x && a.getCorner().y == b.getCorner().y
+			&& a.getDimensions().x == b.getDimensions().x && a.getDimensions().y == b.getDimensions().y;
+	};
+
+	size_t index = 0;
+	for (const auto &tile : chunk.tiles) {
+		const std::vector<Rectangle> &copied = chunk.tile_hitboxes[index++];
+		const size_t count = tile.hitbox ? tile.hitbox->rectangles.size() : 0;
+
+		if (count != copied.size()) { return true; }
+		for (size_t i = 0; i < count; ++i) { if (!sameRect(tile.hitbox->rectangles[i], copied[i])) return true; }
 	}
+
+	return false;
 }
-void Level::parse_objectgroup_script_XOR(const nlohmann::json &objectgroup_node) {
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
 
-		std::string emit_output = ""; // optional
-		int emit_output_lifetime = 0; // optional
+void Level::unload_Chunk(const Vector2 &index) {
+	this->chunks.erase(chunk_key(index));
 
-		std::unordered_set<std::string> emit_inputs;
+	// Despawn level entities that are now outside of loaded chunks, they will be respawned once their spawn chunk is loaded again
+	// Entities spawned at runtime (dropped items, projectiles) can't be respawned, so they are kept frozen instead
+	for (auto iter = this->entities.begin(); iter != this->entities.end();) {
+		const auto spawn = this->spawned_entities.find(&(*iter));
 
-		// Parse custom properties
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+		if (spawn != this->spawned_entities.end() && !this->chunks.count(chunk_key(this->chunk_of(iter->position.toVector2())))) {
+			this->spawn_states[spawn->second] = SpawnState::PENDING;
+			this->spawned_entities.erase(spawn);
 
-			if (prefix == "emit_output") {
-				emit_output = property_node["value"].get<std::string>();
-			}
-			else if (prefix == "emit_output_lifetime") {
-				emit_output_lifetime = property_node["value"].get<int>();
-			}
-			else if (prefix == "emit_input") {
-				// we don't care about suffix in this case, we only care about having duplicates-by-prefix
-				emit_inputs.insert(property_node["value"].get<std::string>());
-			}
+			iter = this->entities.erase(iter); // last entity takes its place
+		}
+		else {
+			++iter;
 		}
-
-		auto script = std::make_unique<scripts::XOR>(emit_inputs);
-		script->setOutput(emit_output, emit_output_lifetime);
-
-		this->scripts.insert(std::move(script));
 	}
 }
-void Level::parse_objectgroup_script_NAND(const nlohmann::json &objectgroup_node) {
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
 
-		std::string emit_output = ""; // optional
-		int emit_output_lifetime = 0; // optional
+Vector2 Level::chunk_of(const Vector2 &position) const {
+	const auto floorDiv = [](int value) { return (value >= 0) ? (value / CHUNK_SIZE_PIXELS) : ((value + 1) / CHUNK_SIZE_PIXELS - 1); };
+	return Vector2(floorDiv(position.x), floorDiv(position.y));
+}
+bool Level::chunk_active(const Vector2 &index) const {
+	return std::abs(index.x - this->player_chunk.x) <= CHUNK_ACTIVE_RADIUS && std::abs(index.y - this->player_chunk.y) <= CHUNK_ACTIVE_RADIUS;
+}
+int64_t Level::chunk_key(const Vector2 &index) {
+	// Shifting is done on unsigned values, since indices can be negative
+	return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(index.x)) << 32) | static_cast<uint32_t>(index.y));
+}
+
+_tile_kind& Level::get_TileKind(int gid) {
+	gid = strip_Flags(gid);
 
-		std::unordered_set<std::string> emit_inputs;
+	// Gid is validated before it's used as an index, so corrupted gids can't blow up 'tile_kinds'
+	if (static_cast<size_t>(gid) >= this->tile_kinds.size() || !this->tile_kinds[gid].resolved) {
+		const auto tileset = this->get_Tileset(gid);
+		if (tileset == this->tilesets.end()) { return this->invalid_tile_kind; }
 
-		// Parse custom properties
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+		const int id = gid - tileset->second.firstGid;
 
-			if (prefix == "emit_output") {
-				emit_output = property_node["value"].get<std::string>();
-			}
-			else if (prefix == "emit_output_lifetime") {
-				emit_output_lifetime = property_node["value"].get<int>();
-			}
-			else if (prefix == "emit_input") {
-				// we don't care about suffix in this case, we only care about having duplicates-by-prefix
-				emit_inputs.insert(property_node["value"].get<std::string>());
-			}
+		int tileCount;
+		bool animated;
+		{
+			std::lock_guard<std::mutex> lock(tilesetsMutex);
+			const _tileset_info &info = get_TilesetInfo(tileset->first);
+			tileCount = info.tile_count;
+			animated = info.animated_tiles.count(id) > 0;
 		}
 
-		auto script = std::make_unique<scripts::NAND>(emit_inputs);
-		script->setOutput(emit_output, emit_output_lifetime);
+		if (id >= tileCount) { return this->invalid_tile_kind; }
 
-		this->scripts.insert(std::move(script));
-	}
-}
-void Level::parse_objectgroup_script_NOR(const nlohmann::json &objectgroup_node) {
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
+		if (static_cast<size_t>(gid) >= this->tile_kinds.size()) { this->tile_kinds.resize(gid + 1); }
 
-		std::string emit_output = ""; // optional
-		int emit_output_lifetime = 0; // optional
+		_tile_kind &kind = this->tile_kinds[gid];
 
-		std::unordered_set<std::string> emit_inputs;
+		auto tile = tiles::make_tile(tileset->second, id, Vector2(0, 0));
 
-		// Parse custom properties
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+		// 'make_tile()' returns derived classes for interactive tiles, regular 'Tile' otherwise
+		const Tile &tileRef = *tile;
+		kind.valid = true;
+		kind.interactive = (typeid(tileRef) != typeid(Tile));
+		kind.animated = animated;
+		if (!kind.interactive) { kind.prototype = std::move(tile); }
 
-			if (prefix == "emit_output") {
-				emit_output = property_node["value"].get<std::string>();
-			}
-			else if (prefix == "emit_output_lifetime") {
-				emit_output_lifetime = property_node["value"].get<int>();
-			}
-			else if (prefix == "emit_input") {
-				// we don't care about suffix in this case, we only care about having duplicates-by-prefix
-				emit_inputs.insert(property_node["value"].get<std::string>());
-			}
-		}
+		kind.resolved = true;
+	}
 
-		auto script = std::make_unique<scripts::NOR>(emit_inputs);
-		script->setOutput(emit_output, emit_output_lifetime);
+	return this->tile_kinds[gid];
+}
+std::map<std::string, Tileset>::iterator Level::get_Tileset(int gid) {
+	// Determine which tileset tile belongs to (tilesets are ordered by name, not by gid)
+	auto result = this->tilesets.end();
+	for (auto iter = this->tilesets.begin(); iter != this->tilesets.end(); ++iter) {
+		if (gid >= iter->second.firstGid && (result == this->tilesets.end() || iter->second.firstGid > result->second.firstGid)) { result = iter; }
+	}
+	return result;
+}
+
+void Level::add_Tile(Collection<Tile> &tileObjects, int gid, const Vector2 position) {
+	// Interactive and animated tiles remain independent objects (gid was already validated by 'get_TileKind()')
+	gid = strip_Flags(gid);
+	Tileset &tileset = this->get_Tileset(gid)->second;
+	tileObjects.insert(tiles::make_tile(tileset, gid - tileset.firstGid, position));
+}
+void Level::add_Entity(size_t spawnIndex) {
+	const LevelData::EntitySpawn &spawn = this->data.entities[spawnIndex];
+
+	auto handle = this->entities.insert(entities::make_entity(spawn.type, spawn.name, spawn.position));
+
+	this->spawned_entities[&handle.get()] = spawnIndex;
+	this->spawn_states[spawnIndex] = SpawnState::ALIVE;
+}
+void Level::add_Script(_level_chunk &chunk, const LevelData::ScriptDef &def) {
+	using Type = LevelData::ScriptType;
+
+	const std::unordered_set<std::string> emitInputs(def.emit_inputs.begin(), def.emit_inputs.end());
+
+	std::unique_ptr<Script> script;
+
+	switch (def.type) {
+	case Type::LEVEL_CHANGE:
+		script = std::make_unique<scripts::LevelChange>(def.hitbox, def.goes_to_level, def.goes_to_pos);
+		break;
+	case Type::LEVEL_SWITCH:
+		script = std::make_unique<scripts::LevelSwitch>(def.hitbox, def.goes_to_level, def.goes_to_pos);
+		break;
+	case Type::PLAYER_IN_AREA:
+		script = std::make_unique<scripts::PlayerInArea>(def.hitbox);
+		break;
+	case Type::AND:
+		script = std::make_unique<scripts::AND>(emitInputs);
+		break;
+	case Type::OR:
+		script = std::make_unique<scripts::OR>(emitInputs);
+		break;
+	case Type::XOR:
+		script = std::make_unique<scripts::XOR>(emitInputs);
+		break;
+	case Type::NAND:
+		script = std::make_unique<scripts::NAND>(emitInputs);
+		break;
+	case Type::NOR:
+		script = std::make_unique<scripts::NOR>(emitInputs);
+		break;
+	case Type::XNOR:
+		script = std::make_unique<scripts::XNOR>(emitInputs);
+		break;
+	default:
+		return; // unknown script type
+	}
 
-		this->scripts.insert(std::move(script));
+	// Level changes don't emit anything
+	if (def.type != Type::LEVEL_CHANGE && def.type != Type::LEVEL_SWITCH) {
+		script->setOutput(def.emit_output, def.emit_output_lifetime);
 	}
+
+	chunk.scripts.insert(std::move(script));
 }
-void Level::parse_objectgroup_script_XNOR(const nlohmann::json &objectgroup_node) {
-	const nlohmann::json &objects_array_node = objectgroup_node["objects"];
-	for (const auto &object_node : objects_array_node) {
 
-		std::string emit_output = ""; // optional
-		int emit_output_lifetime = 0; // optional
+// Utility
 
-		std::unordered_set<std::string> emit_inputs;
+bool Level::unfreezed(const Entity& entity) const {
+	const Vector2 index = this->chunk_of(entity.position.toVector2());
+	return this->chunk_active(index) && this->chunks.count(chunk_key(index));
+}
 
-		// Parse custom properties
-		for (const auto &property_node : object_node["properties"]) {
-			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+void Level::damageInArea(const Rectangle &area, const Damage &damage) {
+	if (EffectBuffer::deferring()) { // damaged entities might be updating on other threads right now
+		EffectBuffer::defer([this, area, damage]() { this->damageInArea(area, damage); });
+		return;
+	}
 
-			if (prefix == "emit_output") {
-				emit_output = property_node["value"].get<std::string>();
-			}
-			else if (prefix == "emit_output_lifetime") {
-				emit_output_lifetime = property_node["value"].get<int>();
-			}
-			else if (prefix == "emit_input") {
-				// we don't care about suffix in this case, we only care about having duplicates-by-prefix
-				emit_inputs.insert(property_node["value"].get<std::string>());
-			}
+	// Look for entities that should be damaged
+	for (auto &entity : this->entities) {
+		// Deal damage if entity has health+hitbox, is in the area, and of the enemy faction
+		if (entity.health && entity.solid && area.overlapsWithRect(entity.solid->getHitbox())) {
+			entity.health->applyDamage(damage);
 		}
+	}
 
-		auto script = std::make_unique<scripts::XNOR>(emit_inputs);
-		script->setOutput(emit_output, emit_output_lifetime);
-
-		this->scripts.insert(std::move(script));
+	// Check the same for player
+	if (area.overlapsWithRect(this->player->solid->getHitbox())) {
+		this->player->health->applyDamage(damage);
 	}
-}
\ No newline at end of file
+}
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <map> // related type (tileset storing, order is important)
-#include "nlohmann_external.hpp" // parsing from JSON, 'nlohmann::json' type
+#include <vector> // related type (tile layers)
+#include <unordered_map> // related type (chunk storing)
+#include <cstdint> // 'int64_t' type (chunk keys)
 
 #include "geometry_utils.h" // geometry types
 #include "tile_base.h" // 'Tile' base class
@@ -9,15 +11,71 @@
 #include "script_base.h" // 'Script' base class
 #include "player.h" // 'Player' base class
 #include "collection.hpp" // 'Collection' class
+#include "hitbox_grid.h" // 'HitboxGrid' class
+#include "effect_buffer.h" // 'EffectBuffer' class (parallel entity updates)
+#include "level_data.h" // 'LevelData' struct
 #include "timer.h" // 'Milliseconds' type
 
 
 
+// # _tile_kind #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Holds data shared by all tiles with the same gid
+// - Static tiles that aren't animated are not stored as objects, they are pre-rendered through a single 'prototype'
+// - Animated static tiles are separate objects, so each one has its own position and animation phase
+struct _tile_kind {
+	bool resolved = false; // kind is resolved upon first encounter of the gid
+	bool valid = false; // false => gid doesn't belong to any tileset of the level, such tiles are skipped
+	bool interactive = false; // interactive tiles are stored as unique objects
+	bool animated = false; // animated static tiles can't be pre-rendered
+
+	std::unique_ptr<Tile> prototype; // tile constructed at (0, 0), never moved, drawn in place of tiles through 'Camera::setDrawOffset()'
+};
+
+
+
+// # _texture_deleter #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Allows storing owned render targets (made by 'Graphics::createTarget()') in 'std::unique_ptr'
+struct _texture_deleter {
+	void operator()(SDL_Texture* texture) const;
+};
+
+
+
+// # _level_chunk #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Holds all objects of a loaded chunk, objects are created upon loading and destroyed upon unloading
+// - Static tile gids are not copied, they are read from the level description
+// - Static tiles that aren't animated are pre-rendered into a single texture
+struct _level_chunk {
+	Vector2 index; // position in chunks
+
+	int source = -1; // index of tile chunk in level description, -1 => chunk has no tiles
+
+	Collection<Tile> tiles; // interactive tiles
+	Collection<Script> scripts;
+
+	HitboxGrid hitbox_grid; // broadphase for tile hitboxes of this chunk
+	std::vector<std::vector<Rectangle>> tile_hitboxes; // hitboxes of interactive tiles copied into 'hitbox_grid', in order of tiles
+
+	std::unique_ptr<SDL_Texture, _texture_deleter> baked_tiles; // pre-rendered static tiles, nullptr if there are none
+	Collection<Tile> animated_tiles; // animated static tiles, in order of layers
+
+	bool dirty = true; // static tiles changed => hitboxes and pre-rendered texture need to be rebuilt
+};
+
+
+
 // # Level #
 // - Holds all tiles, entities and scripts present on a map
 // - Holds all tilesets, tiles and their hitboxes on the level
 // - Holds level background
 // - Handles updating and drawing of all aforementioned objects
+// - Map is split into chunks that are loaded around the player and camera, tiles and scripts of a chunk
+// are created/destroyed together, entities are spawned by their chunk and despawned when their current chunk unloads,
+// entities spawned at runtime (not described by the level) are kept frozen instead
+// - Only chunks near the player are active (updated and drawn)
 class Level {
 public:
 	Level() {};
@@ -25,69 +83,107 @@ public:
 	Level(const std::string &mapName, const std::string &mapVersion);
 	Level(const std::string &mapName, const std::string &mapVersion, std::unique_ptr<Player> &&player);
 		// also inits player upon construction
+	Level(const std::string &mapName, const std::string &mapVersion, LevelData &&data);
+	Level(const std::string &mapName, const std::string &mapVersion, LevelData &&data, std::unique_ptr<Player> &&player);
+		// same as above, but constructs level from an already loaded description (aka preloaded level)
 
 	//Level& operator=(const Level &other) = delete;
 
 	void update(Milliseconds elapsedTime); // updates all logic, scripts and tile animations of the level
+	void stream(); // loads chunks around player/camera and unloads distant ones, touches the renderer so it's called between simulation runs
 	void draw() const;
 
+	void beginInterpolation(double alpha); // moves entities <alpha> of the way from previous to current positions, for drawing only
+	void endInterpolation(); // moves entities back to their simulated positions
+
 	// Construction
 	void loadLevel(const std::string &mapName);
 	void initPlayer(std::unique_ptr<Player> &&player);
 
-	void parseFromJSON(const std::string &filePath);
+	void build(LevelData &&data); // sets up level from a level description, chunks are loaded later during updates
+
+	static void forgetTilesets(); // drops cached tileset info, so edited tilesets are re-read by the next level (hot reload)
 
 	// Getters
 	const Vector2& getSize() const;
+	const Vector2& getOrigin() const; // Tiled coordinates of the level top-left corner (non-zero only for infinite maps)
 	const std::string& getName() const;
 	const std::string& getVersion() const;
+	const std::vector<std::string>& getNeighbors() const; // returns names of levels reachable through level changes/switches
+
+	void getHitboxGrids(const Rectangle &area, std::vector<const HitboxGrid*> &result) const;
+		// fills <result> with hitbox grids of all loaded chunks that can contain hitboxes touching given area
+
+	// Modification
+	bool setTile(int layer, const Vector2 &tilePosition, int gid);
+		// replaces static tile at given position (in tiles), 0 gid removes the tile, only affected chunk is rebuilt
+		// interactive tiles can't be placed or replaced this way (returns false)
 
 	std::unique_ptr<Player> player;
 
-	Collection<Tile> tiles; // holds all individual tiles for a level, polimorphism allows convenient storage and usage of different types of tiles
 	Collection<Entity> entities; // holds all entities present on a level
-	Collection<Script> scripts;
 
 	// Utility
-	bool unfreezed(const Tile& tile) const;
-	bool unfreezed(const Entity& entity) const;
+	bool unfreezed(const Entity& entity) const; // returns whether chunk entity is located in is active
 
 	void damageInArea(const Rectangle &area, const Damage &damage);
 		// deals damage to every entity in given area (unless fraction is the same)
+		// deferred until the end of entity updates when called from an entity update
+
+	static const size_t ENTITIES_PER_TASK = 32; // entities are updated in parallel tasks of this size
 
 private:
+	void update_Entities(Milliseconds elapsedTime); // updates active entities on worker threads, applies their effects afterwards
 	void clearDeadEntities();
 
-	// Tile functions
-	void parse_tilelayer(const nlohmann::json &tilelayer_node); // does all tilelayer parsing
+	// Chunks
+	void update_Chunks(); // loads chunks around player/camera, unloads distant ones
+	void load_Chunk(const Vector2 &index);
+	void unload_Chunk(const Vector2 &index);
+	void rebuild_Chunk(_level_chunk &chunk); // rebuilds hitboxes and pre-rendered texture of static tiles
+	void rebuild_ChunkHitboxes(_level_chunk &chunk); // rebuilds hitbox grid only, doesn't touch the renderer, so it's safe during simulation
+	bool tileHitboxes_changed(const _level_chunk &chunk) const; // returns whether interactive tiles moved, gained or lost hitboxes since the last rebuild
 
-	// Entity parsing
-	void parse_objectgroup(const nlohmann::json &objectgroup_node); // redirects to parse_entity() or parse_script()
-	void parse_objectgroup_entity(const nlohmann::json &objectgroup_node);
+	Vector2 chunk_of(const Vector2 &position) const; // returns index of a chunk containing given point
+	bool chunk_active(const Vector2 &index) const;
+	static int64_t chunk_key(const Vector2 &index);
 
-	// Scripts parsing
-	void parse_objectgroup_script_levelChange(const nlohmann::json &objectgroup_node);
-	void parse_objectgroup_script_levelSwitch(const nlohmann::json &objectgroup_node);
-	void parse_objectgroup_script_PlayerInArea(const nlohmann::json &objectgroup_node);
-	void parse_objectgroup_script_AND(const nlohmann::json &objectgroup_node);
-	void parse_objectgroup_script_OR(const nlohmann::json &objectgroup_node);
-	void parse_objectgroup_script_XOR(const nlohmann::json &objectgroup_node);
-	void parse_objectgroup_script_NAND(const nlohmann::json &objectgroup_node);
-	void parse_objectgroup_script_NOR(const nlohmann::json &objectgroup_node);
-	void parse_objectgroup_script_XNOR(const nlohmann::json &objectgroup_node);
+	_tile_kind& get_TileKind(int gid); // resolves tile kind upon first call, flip flags of <gid> are ignored
+	std::map<std::string, Tileset>::iterator get_Tileset(int gid); // returns tileset that gid belongs to, 'tilesets.end()' if there is none
 
-
-	void add_Tile(Tileset &tileset, int id, const Vector2 position); // adds tile to the level with respect to its interactions and etc
-	void add_Entity(const std::string &type, const std::string &name, Vector2d position);
+	void add_Tile(Collection<Tile> &tileObjects, int gid, const Vector2 position); // adds tile object (interactive or animated) to <tileObjects>
+	void add_Entity(size_t spawnIndex); // spawns entity described by 'data.entities[spawnIndex]'
+	void add_Script(_level_chunk &chunk, const LevelData::ScriptDef &def);
 	// no need for 'add_Item()' as items can't exist outside of inventories
-	// no need for 'add_Script()' as scripts can't be standardiez under the same constructor parameters
+
+	LevelData data; // level description, chunks are constructed from it
 
 	std::map<std::string, Tileset> tilesets; // holds all tilesets for given level   NOTE: map is ordered because we iterate through tilesets when determining tileset by gid
+	std::vector<_tile_kind> tile_kinds; // indexed by gid (without flip flags)
+	_tile_kind invalid_tile_kind; // returned for gids out of range of level tilesets
 
-	SDL_Texture* background;
+	std::unordered_map<int64_t, _level_chunk> chunks; // loaded chunks
+	Vector2 player_chunk; // chunks are activated around this one
+
+	// Objects are assigned to chunks by their position
+	std::unordered_map<int64_t, size_t> chunk_tiles; // chunk key => index in 'data.chunks'
+	std::unordered_map<int64_t, std::vector<size_t>> chunk_entities; // chunk key => indices in 'data.entities'
+	std::unordered_map<int64_t, std::vector<size_t>> chunk_scripts; // chunk key => indices in 'data.scripts'
+
+	// Entity spawns (killed entities are not respawned, despawned ones are)
+	enum class SpawnState { PENDING, ALIVE, DEAD };
+	std::vector<SpawnState> spawn_states; // indexed same as 'data.entities'
+	std::unordered_map<const Entity*, size_t> spawned_entities; // entity => index in 'data.entities'
+
+	std::vector<Vector2d> simulated_positions; // positions of entities (player last) saved during interpolation
 
-	Vector2 mapSize;
+	std::vector<Entity*> active_entities; // entities updated during current step
+	std::vector<EffectBuffer> effect_buffers; // one per update task
+
+	SDL_Texture* background;
 
 	std::string levelName;
 	std::string levelVersion;
+
+	std::vector<std::string> neighbor_levels; // filled from level change/switch scripts
 };
\ No newline at end of file
@@ -0,0 +1,637 @@
+#include "level_data.h"
+
+#include <fstream> // writing cache files
+#include <filesystem> // creation of cache folder, atomic file replacement
+#include <cstring> // 'std::memcpy()'
+#include <cstdio> // 'snprintf()'
+#include <thread> // 'std::this_thread::get_id()' (unique temporary files)
+#include <chrono> // benchmark timing
+#include <iostream> // benchmark output
+#include <algorithm> // 'std::min()', 'std::max()'
+#include <unordered_map> // related type (script type lookup)
+#include "nlohmann_external.hpp" // parsing from JSON, 'nlohmann::json' type
+
+#include "content_archive.h" // 'ContentFile' class
+#include "tags.h" // tag utility
+#include "globalconsts.hpp" // tile size (infinite map origin)
+#include "entity_unique.h" // entity textures (asset manifest)
+
+
+
+/* ### JSON PARSING ### */
+
+namespace {
+	const std::unordered_map<std::string, LevelData::ScriptType> SCRIPT_TYPES = {
+		{ "level_change", LevelData::ScriptType::LEVEL_CHANGE },
+		{ "level_switch", LevelData::ScriptType::LEVEL_SWITCH },
+		{ "player_in_area", LevelData::ScriptType::PLAYER_IN_AREA },
+		{ "AND", LevelData::ScriptType::AND },
+		{ "OR", LevelData::ScriptType::OR },
+		{ "XOR", LevelData::ScriptType::XOR },
+		{ "NAND", LevelData::ScriptType::NAND },
+		{ "NOR", LevelData::ScriptType::NOR },
+		{ "XNOR", LevelData::ScriptType::XNOR }
+		// new script types go there
+	};
+
+	// # _chunk_builder #
+	// - Distributes tiles between chunks, chunks are created upon first tile
+	class _chunk_builder {
+	public:
+		_chunk_builder(LevelData &data) : data(data) {}
+
+		void set(int layer, int x, int y, int gid) {
+			if (!gid || x < 0 || y < 0 || x >= this->data.mapSize.x || y >= this->data.mapSize.y) { return; }
+
+			const int CHUNK_SIZE = LevelData::CHUNK_SIZE;
+			const Vector2 index(x / CHUNK_SIZE, y / CHUNK_SIZE);
+			const int64_t key = (static_cast<int64_t>(index.x) << 32) | static_cast<uint32_t>(index.y);
+
+			auto iter = this->lookup.find(key);
+			if (iter == this->lookup.end()) {
+				LevelData::TileChunk chunk;
+				chunk.index = index;
+				chunk.layers.assign(this->data.layerCount, std::vector<int>(CHUNK_SIZE * CHUNK_SIZE, 0));
+
+				this->data.chunks.push_back(std::move(chunk));
+				iter = this->lookup.emplace(key, this->data.chunks.size() - 1).first;
+			}
+
+			this->data.chunks[iter->second].layers[layer][(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE] = gid;
+		}
+
+	private:
+		LevelData &data;
+		std::unordered_map<int64_t, size_t> lookup; // chunk key => index in 'data.chunks'
+	};
+
+	void parse_tilelayer(const nlohmann::json &tilelayer_node, int layer, _chunk_builder &builder, const LevelData &data) {
+		const Vector2 originTile = data.origin / rendering::TILE_SIZE;
+
+		if (tilelayer_node.contains("chunks")) {
+			// Infinite maps store layers as a set of chunks
+			for (const auto &chunk_node : tilelayer_node["chunks"]) {
+				const int chunkX = chunk_node["x"].get<int>() - originTile.x;
+				const int chunkY = chunk_node["y"].get<int>() - originTile.y;
+				const int chunkWidth = chunk_node["width"].get<int>();
+
+				int tileCount = 0; // used to determine tile position
+				for (const auto &data_node : chunk_node["data"]) {
+					builder.set(layer, chunkX + tileCount % chunkWidth, chunkY + tileCount / chunkWidth, data_node.get<int>());
+					++tileCount;
+				}
+			}
+		}
+		else {
+			// Regular maps store layers as a single array
+			int tileCount = 0; // used to determine tile position
+			for (const auto &data_node : tilelayer_node["data"]) {
+				builder.set(layer, tileCount % data.mapSize.x, tileCount / data.mapSize.x, data_node.get<int>());
+				++tileCount;
+			}
+		}
+	}
+
+	void parse_mapBounds(const nlohmann::json &JSON, LevelData &data) {
+		if (!JSON.value("infinite", false)) {
+			data.mapSize.x = JSON["width"].get<int>();
+			data.mapSize.y = JSON["height"].get<int>();
+			return;
+		}
+
+		// Infinite maps only have chunks, bounds are determined by the chunks present
+		bool first = true;
+		Vector2 min, max; // in tiles
+
+		for (const auto &layer_node : JSON["layers"]) {
+			if (!layer_node.contains("chunks")) { continue; }
+
+			for (const auto &chunk_node : layer_node["chunks"]) {
+				const int x = chunk_node["x"].get<int>();
+				const int y = chunk_node["y"].get<int>();
+				const int w = chunk_node["width"].get<int>();
+				const int h = chunk_node["height"].get<int>();
+
+				min.set(first ? x : std::min(min.x, x), first ? y : std::min(min.y, y));
+				max.set(first ? x + w : std::max(max.x, x + w), first ? y + h : std::max(max.y, y + h));
+				first = false;
+			}
+		}
+
+		data.mapSize = max - min;
+		data.origin = min * rendering::TILE_SIZE;
+	}
+
+	void parse_objectgroup_entity(const nlohmann::json &objectgroup_node, LevelData &data) {
+		const std::string entity_type = tags::getSuffix(objectgroup_node["name"].get<std::string>());
+
+		for (const auto &object_node : objectgroup_node["objects"]) {
+			LevelData::EntitySpawn spawn;
+			spawn.type = entity_type;
+			spawn.position = Vector2(object_node["x"].get<int>(), object_node["y"].get<int>()) - data.origin;
+
+			// Parse custom properties
+			for (const auto &property_node : object_node["properties"]) {
+				const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+
+				if (prefix == "name") {
+					spawn.name = property_node["value"].get<std::string>();
+				}
+			}
+
+			data.entities.push_back(std::move(spawn));
+		}
+	}
+
+	void parse_objectgroup_script(const nlohmann::json &objectgroup_node, LevelData::ScriptType type, LevelData &data) {
+		for (const auto &object_node : objectgroup_node["objects"]) {
+			LevelData::ScriptDef script;
+			script.type = type;
+
+			// Parse hitbox (points have no size)
+			script.hitbox = Rectangle(
+				object_node["x"].get<int>() - data.origin.x, object_node["y"].get<int>() - data.origin.y,
+				object_node.value("width", 0), object_node.value("height", 0)
+			);
+
+			// Parse custom properties
+			for (const auto &property_node : object_node["properties"]) {
+				const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+
+				if (prefix == "goes_to_level") {
+					script.goes_to_level = property_node["value"].get<std::string>();
+				}
+				else if (prefix == "goes_to_x") {
+					script.goes_to_pos.x = property_node["value"].get<int>();
+				}
+				else if (prefix == "goes_to_y") {
+					script.goes_to_pos.y = property_node["value"].get<int>();
+				}
+				else if (prefix == "emit_output") {
+					script.emit_output = property_node["value"].get<std::string>();
+				}
+				else if (prefix == "emit_output_lifetime") {
+					script.emit_output_lifetime = property_node["value"].get<int>();
+				}
+				else if (prefix == "emit_input") {
+					// we don't care about suffix in this case, we only care about having duplicates-by-prefix
+					script.emit_inputs.push_back(property_node["value"].get<std::string>());
+				}
+			}
+
+			data.scripts.push_back(std::move(script));
+		}
+	}
+
+	void parse_objectgroup(const nlohmann::json &objectgroup_node, LevelData &data) {
+		// get layer prefix and suffix
+		const std::string layer_prefix = tags::getPrefix(objectgroup_node["name"].get<std::string>());
+		const std::string layer_suffix = tags::getSuffix(objectgroup_node["name"].get<std::string>());
+
+		if (layer_prefix == "entity") {
+			parse_objectgroup_entity(objectgroup_node, data);
+		}
+		else if (layer_prefix == "script") {
+			const auto type = SCRIPT_TYPES.find(layer_suffix);
+			if (type != SCRIPT_TYPES.end()) { parse_objectgroup_script(objectgroup_node, type->second, data); }
+		}
+	}
+
+	// Manifest => textures of background, tilesets and entities without duplicates (scripts have no textures)
+	void make_manifest(LevelData &data) {
+		std::vector<std::string> &textures = data.textures;
+
+		const auto add = [&textures](const std::string &path) {
+			if (std::find(textures.begin(), textures.end(), path) == textures.end()) { textures.push_back(path); }
+		};
+
+		if (!data.background.empty()) { add("content/textures/backgrounds/" + data.background); }
+
+		for (const auto &tileset : data.tilesets) {
+			const ContentFile tilesetFile("content/tilesets/" + tileset.fileName);
+			if (!tilesetFile.data()) { continue; }
+
+			const nlohmann::json tilesetJSON = nlohmann::json::parse(tilesetFile.data(), tilesetFile.data() + tilesetFile.size(), nullptr, false); // no exceptions
+			if (!tilesetJSON.is_object() || !tilesetJSON.contains("image")) { continue; }
+
+			std::string imageName = tilesetJSON["image"].get<std::string>();
+			imageName = imageName.substr(imageName.rfind("/") + 1); // cut before '/'
+			imageName = imageName.substr(imageName.rfind("\\") + 1); // cut before '\'
+
+			add("content/textures/tilesets/" + imageName);
+		}
+
+		for (const auto &entity : data.entities) {
+			for (const auto &path : entities::get_textures(entity.type, entity.name)) { add(path); }
+		}
+	}
+}
+
+LevelData level_data::parseJSON(const char* text, size_t length) {
+	const nlohmann::json JSON = nlohmann::json::parse(text, text + length);
+
+	LevelData data;
+
+	// Parse map properties
+	if (JSON.contains("properties")) {
+		for (const auto &property_node : JSON["properties"]) {
+			const std::string prefix = tags::getPrefix(property_node["name"].get<std::string>());
+
+			if (prefix == "background") {
+				data.background = property_node["value"].get<std::string>();
+			}
+			// new properties go there
+		}
+	}
+
+	// Parse tilesets
+	for (const auto &tileset_node : JSON["tilesets"]) {
+		// Extract tileset file name
+		std::string fileName = tileset_node["source"].get<std::string>();
+		fileName = fileName.substr(fileName.rfind("/") + 1); // cut before '/'
+		fileName = fileName.substr(fileName.rfind("\\") + 1); // cut before '\'
+
+		data.tilesets.push_back({ fileName, tileset_node["firstgid"].get<int>() });
+	}
+
+	// Parse map properties (size and etc)
+	parse_mapBounds(JSON, data);
+
+	for (const auto &layer_node : JSON["layers"]) {
+		if (layer_node["type"].get<std::string>() == "tilelayer") { ++data.layerCount; }
+	}
+
+	// Parse layers
+	_chunk_builder builder(data);
+	int tileLayer = 0;
+
+	for (const auto &layer_node : JSON["layers"]) {
+		const std::string layer_type = layer_node["type"].get<std::string>(); // can be "tilelayer" or "objectgroup"
+
+		if (layer_type == "tilelayer") {
+			parse_tilelayer(layer_node, tileLayer++, builder, data);
+		}
+		else if (layer_type == "objectgroup") {
+			parse_objectgroup(layer_node, data);
+		}
+	}
+
+	make_manifest(data);
+
+	return data;
+}
+
+
+
+/* ### BINARY FORMAT ### */
+
+// Layout (all values are little-endian, every field is aligned to 4 bytes, so tile arrays
+// can be read directly from a mapped file):
+// - header: magic, format version
+// - background: string
+// - map size, origin: 4 x int32
+// - tilesets: count, then (string file name, int32 firstgid) for each
+// - tile chunks: layer count, chunk count, then (2 x int32 index, layer count * CHUNK_SIZE^2 int32 gids) for each
+// - entities: count, then (string type, string name, 2 x int32 position) for each
+// - scripts: count, then (int32 type, 4 x int32 hitbox, string level, 2 x int32 position,
+//   string emit output, int32 emit lifetime, count + strings emit inputs) for each
+// - textures: count, then string path for each
+// Strings are stored as int32 length followed by characters, padded to 4 bytes
+
+namespace {
+	const uint32_t BINARY_MAGIC = 0x564C4D48; // "HMLV"
+	const uint32_t BINARY_VERSION = 3; // increment upon any change to layout
+
+	// # _binary_writer #
+	class _binary_writer {
+	public:
+		void i32(int32_t value) { this->raw(&value, sizeof(value)); }
+		void u32(uint32_t value) { this->raw(&value, sizeof(value)); }
+
+		void str(const std::string &value) {
+			this->u32(static_cast<uint32_t>(value.size()));
+			this->buffer += value;
+			this->buffer.append((4 - value.size() % 4) % 4, '\0'); // padding
+		}
+
+		void raw(const void* source, size_t size) {
+			this->buffer.append(static_cast<const char*>(source), size);
+		}
+
+		std::string buffer;
+	};
+
+	// # _binary_reader #
+	// - Every read is bounds-checked, after the first failed read 'good' stays false
+	class _binary_reader {
+	public:
+		_binary_reader(const char* bytes, size_t length) : cursor(bytes), end(bytes + length) {}
+
+		int32_t i32() { int32_t value = 0; this->raw(&value, sizeof(value)); return value; }
+		uint32_t u32() { uint32_t value = 0; this->raw(&value, sizeof(value)); return value; }
+
+		std::string str() {
+			const size_t size = this->u32();
+			const size_t padded = size + (4 - size % 4) % 4;
+			if (!this->available(padded)) { return std::string(); }
+
+			std::string value(this->cursor, size);
+			this->cursor += padded;
+			return value;
+		}
+
+		void raw(void* destination, size_t size) {
+			if (!this->available(size)) { return; }
+
+			std::memcpy(destination, this->cursor, size);
+			this->cursor += size;
+		}
+
+		void skip(size_t size) {
+			if (!this->available(size)) { return; }
+
+			this->cursor += size;
+		}
+
+		size_t position(const char* bytes) const { return this->cursor - bytes; } // offset from <bytes> the reader was created with
+
+		bool available(size_t size) {
+			if (static_cast<size_t>(this->end - this->cursor) < size) { this->good = false; }
+			return this->good;
+		}
+
+		bool good = true;
+
+	private:
+		const char* cursor;
+		const char* end;
+	};
+}
+
+std::string level_data::toBinary(const LevelData &data) {
+	_binary_writer writer;
+
+	writer.u32(BINARY_MAGIC);
+	writer.u32(BINARY_VERSION);
+
+	writer.str(data.background);
+
+	writer.i32(data.mapSize.x);
+	writer.i32(data.mapSize.y);
+	writer.i32(data.origin.x);
+	writer.i32(data.origin.y);
+
+	writer.u32(static_cast<uint32_t>(data.tilesets.size()));
+	for (const auto &tileset : data.tilesets) {
+		writer.str(tileset.fileName);
+		writer.i32(tileset.firstGid);
+	}
+
+	writer.u32(static_cast<uint32_t>(data.layerCount));
+	writer.u32(static_cast<uint32_t>(data.chunks.size()));
+	for (size_t i = 0; i < data.chunks.size(); ++i) {
+		writer.i32(data.chunks[i].index.x);
+		writer.i32(data.chunks[i].index.y);
+		for (int layer = 0; layer < data.layerCount; ++layer) {
+			writer.raw(data.getLayer(i, layer), LevelData::CHUNK_SIZE * LevelData::CHUNK_SIZE * sizeof(int32_t));
+		}
+	}
+
+	writer.u32(static_cast<uint32_t>(data.entities.size()));
+	for (const auto &entity : data.entities) {
+		writer.str(entity.type);
+		writer.str(entity.name);
+		writer.i32(entity.position.x);
+		writer.i32(entity.position.y);
+	}
+
+	writer.u32(static_cast<uint32_t>(data.scripts.size()));
+	for (const auto &script : data.scripts) {
+		writer.i32(static_cast<int32_t>(script.type));
+		writer.i32(script.hitbox.getSide(Side::LEFT));
+		writer.i32(script.hitbox.getSide(Side::TOP));
+		writer.i32(script.hitbox.getDimensions().x);
+		writer.i32(script.hitbox.getDimensions().y);
+		writer.str(script.goes_to_level);
+		writer.i32(script.goes_to_pos.x);
+		writer.i32(script.goes_to_pos.y);
+		writer.str(script.emit_output);
+		writer.i32(script.emit_output_lifetime);
+		writer.u32(static_cast<uint32_t>(script.emit_inputs.size()));
+		for (const auto &input : script.emit_inputs) { writer.str(input); }
+	}
+
+	writer.u32(static_cast<uint32_t>(data.textures.size()));
+	for (const auto &texture : data.textures) { writer.str(texture); }
+
+	return writer.buffer;
+}
+
+namespace {
+	bool read_binary(const char* bytes, size_t length, bool copyTiles, LevelData &data) {
+		static_assert(sizeof(int) == sizeof(int32_t), "Tile layers are read as raw 'int' arrays");
+
+		_binary_reader reader(bytes, length);
+
+		if (reader.u32() != BINARY_MAGIC || reader.u32() != BINARY_VERSION) { return false; }
+
+		data.background = reader.str();
+
+		data.mapSize.x = reader.i32();
+		data.mapSize.y = reader.i32();
+		if (data.mapSize.x < 0 || data.mapSize.y < 0) { return false; }
+		data.origin.x = reader.i32();
+		data.origin.y = reader.i32();
+
+		const size_t tilesetCount = reader.u32();
+		for (size_t i = 0; i < tilesetCount && reader.good; ++i) {
+			LevelData::TilesetRef tileset;
+			tileset.fileName = reader.str();
+			tileset.firstGid = reader.i32();
+			data.tilesets.push_back(std::move(tileset));
+		}
+
+		data.layerCount = static_cast<int>(reader.u32());
+		if (data.layerCount < 0) { return false; }
+		const size_t chunkCount = reader.u32();
+		const size_t layerSize = LevelData::CHUNK_SIZE * LevelData::CHUNK_SIZE;
+		for (size_t i = 0; i < chunkCount && reader.available((2 + static_cast<size_t>(data.layerCount) * layerSize) * sizeof(int32_t)); ++i) {
+			LevelData::TileChunk chunk;
+			chunk.index.x = reader.i32();
+			chunk.index.y = reader.i32();
+			chunk.tile_offset = reader.position(bytes);
+			if (copyTiles) {
+				chunk.layers.assign(data.layerCount, std::vector<int>(layerSize));
+				for (auto &layer : chunk.layers) { reader.raw(layer.data(), layerSize * sizeof(int32_t)); }
+			}
+			else {
+				reader.skip(static_cast<size_t>(data.layerCount) * layerSize * sizeof(int32_t)); // read upon request through 'getLayer()'
+			}
+			data.chunks.push_back(std::move(chunk));
+		}
+
+		const size_t entityCount = reader.u32();
+		for (size_t i = 0; i < entityCount && reader.good; ++i) {
+			LevelData::EntitySpawn entity;
+			entity.type = reader.str();
+			entity.name = reader.str();
+			entity.position.x = reader.i32();
+			entity.position.y = reader.i32();
+			data.entities.push_back(std::move(entity));
+		}
+
+		const size_t scriptCount = reader.u32();
+		for (size_t i = 0; i < scriptCount && reader.good; ++i) {
+			LevelData::ScriptDef script;
+			script.type = static_cast<LevelData::ScriptType>(reader.i32());
+			const int x = reader.i32();
+			const int y = reader.i32();
+			const int w = reader.i32();
+			const int h = reader.i32();
+			script.hitbox = Rectangle(x, y, w, h);
+			script.goes_to_level = reader.str();
+			script.goes_to_pos.x = reader.i32();
+			script.goes_to_pos.y = reader.i32();
+			script.emit_output = reader.str();
+			script.emit_output_lifetime = reader.i32();
+			const size_t inputCount = reader.u32();
+			for (size_t k = 0; k < inputCount && reader.good; ++k) { script.emit_inputs.push_back(reader.str()); }
+			data.scripts.push_back(std::move(script));
+		}
+
+		const size_t textureCount = reader.u32();
+		for (size_t i = 0; i < textureCount && reader.good; ++i) { data.textures.push_back(reader.str()); }
+
+		return reader.good;
+	}
+}
+
+bool level_data::fromBinary(const char* bytes, size_t length, LevelData &data) {
+	return read_binary(bytes, length, true, data);
+}
+bool level_data::fromBinary(std::shared_ptr<const MappedFile> file, LevelData &data) {
+	if (!file->is_open() || !read_binary(file->data(), file->size(), false, data)) { return false; }
+
+	data.tile_source = std::move(file); // keeps the mapping alive as long as the description
+	return true;
+}
+
+
+
+/* ### TILE ACCESS ### */
+
+const int* LevelData::getLayer(size_t chunk, int layer) const {
+	const size_t layerSize = CHUNK_SIZE * CHUNK_SIZE;
+
+	if (!this->chunks[chunk].layers.empty()) { return this->chunks[chunk].layers[layer].data(); }
+
+	return reinterpret_cast<const int*>(this->tile_source->data() + this->chunks[chunk].tile_offset) + layer * layerSize;
+		// every field of the binary is aligned to 4 bytes, so gids can be read in place
+}
+int* LevelData::editLayer(size_t chunk, int layer) {
+	const size_t layerSize = CHUNK_SIZE * CHUNK_SIZE;
+
+	TileChunk &tileChunk = this->chunks[chunk];
+	if (tileChunk.layers.empty()) { // mapping is read-only, so edited chunk gets its own copy
+		std::vector<std::vector<int>> layers(this->layerCount);
+		for (int i = 0; i < this->layerCount; ++i) {
+			const int* source = this->getLayer(chunk, i);
+			layers[i].assign(source, source + layerSize);
+		}
+		tileChunk.layers = std::move(layers);
+	}
+
+	return tileChunk.layers[layer].data();
+}
+
+
+
+/* ### CACHE ### */
+
+uint64_t level_data::hash(const char* bytes, size_t length) {
+	uint64_t result = 14695981039346656037ULL;
+	for (size_t i = 0; i < length; ++i) {
+		result ^= static_cast<unsigned char>(bytes[i]);
+		result *= 1099511628211ULL;
+	}
+	return result;
+}
+
+std::string level_data::getSourcePath(const std::string &mapName) {
+	return "content/levels/" + mapName + ".json";
+}
+std::string level_data::getCachePath(uint64_t sourceHash) {
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(sourceHash));
+	return "temp/cache/levels/" + std::string(name) + ".bin";
+}
+
+LevelData level_data::load(const std::string &mapName) {
+	const ContentFile source(getSourcePath(mapName));
+	const uint64_t sourceHash = hash(source.data(), source.size());
+	const std::string cachePath = getCachePath(sourceHash);
+
+	// Cache is present => no need to touch the JSON
+	{
+		LevelData data;
+		if (fromBinary(std::make_shared<const MappedFile>(cachePath), data)) { return data; }
+	}
+
+	// Cache is absent/outdated => parse JSON and make a new cache
+	LevelData data = parseJSON(source.data(), source.size());
+
+	std::error_code error; // cache is optional, failing to write it is not an error
+	std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+	const std::string tempPath = cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+		// write + rename, so a partially written cache is never read, name is unique per thread since
+		// preloading and hot reload can write the same level at once
+	{
+		std::ofstream file(tempPath, std::ios::binary);
+		const std::string binary = toBinary(data);
+		file.write(binary.data(), binary.size());
+	}
+	std::filesystem::rename(tempPath, cachePath, error);
+
+	// Parsed tiles are dropped in favor of the new cache, so they are only read for chunks that get loaded
+	LevelData cached;
+	if (fromBinary(std::make_shared<const MappedFile>(cachePath), cached)) { return cached; }
+
+	return data;
+}
+
+
+
+/* ### BENCHMARK ### */
+
+void level_data::benchmark(const std::string &mapName, int iterations) {
+	using clock = std::chrono::steady_clock;
+
+	const auto toMilliseconds = [](clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	};
+
+	level_data::load(mapName); // ensures cache is present
+
+	size_t checksum = 0; // prevents the work from being optimized away
+
+	// Path 1: read + parse .JSON
+	const auto jsonStart = clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		const ContentFile source(getSourcePath(mapName));
+		checksum += parseJSON(source.data(), source.size()).chunks.size();
+	}
+	const auto jsonTime = clock::now() - jsonStart;
+
+	// Path 2: hash .JSON + read cached binary (aka what 'load()' does)
+	const auto binaryStart = clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		checksum += level_data::load(mapName).chunks.size();
+	}
+	const auto binaryTime = clock::now() - binaryStart;
+
+	std::cout
+		<< "Level " << mapName << " (" << iterations << " iterations, checksum " << checksum << ")" << std::endl
+		<< "    JSON:   " << toMilliseconds(jsonTime) / iterations << " ms per load" << std::endl
+		<< "    binary: " << toMilliseconds(binaryTime) / iterations << " ms per load" << std::endl;
+}
\ No newline at end of file
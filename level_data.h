@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string> // related type
+#include <vector> // related type
+#include <memory> // 'shared_ptr' type (mapped tile source)
+#include <cstdint> // fixed-size types (binary format)
+
+#include "geometry_utils.h" // geometry types
+#include "mapped_file.h" // 'MappedFile' class (tiles are read from mapped cache)
+
+
+
+// # LevelData #
+// - Plain description of a level: contains no game objects, textures or other engine state
+// - Can be parsed from Tiled .JSON or read from a precompiled binary
+// - 'Level' is constructed from this description
+// - Tiles are split into square chunks, only chunks that contain tiles are stored
+// - Levels read from a mapped binary keep only offsets of chunk tiles, tiles stay in the mapping and are
+// paged in by the OS when a chunk reads them through 'getLayer()', so only chunks that get loaded take memory
+// - Holds a manifest of textures used by background, tilesets and entities, so they can be loaded
+// before the level is constructed
+// - Both regular and "infinite" Tiled maps are supported, infinite maps are shifted so all
+// coordinates are non-negative ('origin' holds the shift)
+struct LevelData {
+	static const int CHUNK_SIZE = 16; // in tiles, same as default chunk size of Tiled infinite maps
+
+	// # LevelData::TileChunk #
+	struct TileChunk {
+		Vector2 index; // position in chunks
+		std::vector<std::vector<int>> layers; // row-major arrays of gids (0 => no tile), size is CHUNK_SIZE * CHUNK_SIZE
+			// empty while tiles are only present in 'tile_source'
+		size_t tile_offset = 0; // position of tile layers in 'tile_source'
+	};
+
+	// # LevelData::TilesetRef #
+	struct TilesetRef {
+		std::string fileName; // name of the tileset file inside 'content/tilesets/'
+		int firstGid; // firstgid is map-dependant
+	};
+
+	// # LevelData::EntitySpawn #
+	struct EntitySpawn {
+		std::string type;
+		std::string name;
+		Vector2 position;
+	};
+
+	// # LevelData::ScriptType #
+	enum class ScriptType : uint8_t {
+		LEVEL_CHANGE,
+		LEVEL_SWITCH,
+		PLAYER_IN_AREA,
+		AND,
+		OR,
+		XOR,
+		NAND,
+		NOR,
+		XNOR
+	};
+
+	// # LevelData::ScriptDef #
+	// - Holds all properties any script can have, unused ones are left empty
+	struct ScriptDef {
+		ScriptType type;
+
+		Rectangle hitbox;
+
+		std::string goes_to_level;
+		Vector2 goes_to_pos;
+
+		std::string emit_output;
+		int emit_output_lifetime = 0;
+		std::vector<std::string> emit_inputs;
+	};
+
+	std::string background; // name of the background texture, empty if not present
+
+	Vector2 mapSize; // in tiles
+	Vector2 origin; // Tiled coordinates (in pixels) of the level top-left corner, non-zero only for infinite maps
+
+	std::vector<TilesetRef> tilesets; // in order of appearance
+
+	int layerCount = 0; // number of tile layers, every chunk holds all of them
+	std::vector<TileChunk> chunks; // in no particular order
+	std::shared_ptr<const MappedFile> tile_source; // binary the level was read from, nullptr => all tiles are in 'chunks'
+	std::vector<EntitySpawn> entities;
+	std::vector<ScriptDef> scripts;
+
+	std::vector<std::string> textures; // asset manifest, paths of all textures used by the level in the format of 'Graphics::getTexture()'
+
+	const int* getLayer(size_t chunk, int layer) const; // gids of a single layer of a chunk (CHUNK_SIZE * CHUNK_SIZE of them)
+	int* editLayer(size_t chunk, int layer); // same as above, but copies tiles of the chunk out of 'tile_source' first
+};
+
+
+
+// level_data::
+// - Loading, parsing and caching of level descriptions
+// - Binary files are cached at 'temp/cache/levels/' and named by the hash of the source .JSON,
+// so editing a level automatically invalidates its cache
+namespace level_data {
+	LevelData load(const std::string &mapName); // takes full map name aka "[name]{version}", uses cache when possible
+
+	LevelData parseJSON(const char* text, size_t length); // parses Tiled .JSON
+
+	std::string toBinary(const LevelData &data);
+	bool fromBinary(const char* bytes, size_t length, LevelData &data); // returns false if data is malformed or outdated
+	bool fromBinary(std::shared_ptr<const MappedFile> file, LevelData &data); // same as above, but tiles are left in <file>
+
+	uint64_t hash(const char* bytes, size_t length); // FNV-1a
+
+	std::string getSourcePath(const std::string &mapName); // path to the .JSON
+	std::string getCachePath(uint64_t sourceHash); // path to the binary
+
+	void benchmark(const std::string &mapName, int iterations); // prints average load times of .JSON and binary to console
+}
\ No newline at end of file
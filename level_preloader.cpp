@@ -0,0 +1,73 @@
+#include "level_preloader.h"
+
+#include <algorithm> // 'std::find()'
+#include <chrono> // 'std::chrono::seconds' type (checking future status)
+
+#include "job_system.h" // background loading
+
+
+
+// # LevelPreloader #
+LevelPreloader::~LevelPreloader() {
+	for (auto &load : this->loads) { if (load.second.valid()) load.second.wait(); }
+}
+
+void LevelPreloader::request(const std::string &mapName) {
+	if (this->loads.count(mapName) || this->finished.count(mapName)) { return; }
+
+	this->loads[mapName] = JobSystem::ACCESS->async([mapName]() { return level_data::load(mapName); });
+}
+
+void LevelPreloader::retain(const std::vector<std::string> &mapNames) {
+	for (auto iter = this->loads.begin(); iter != this->loads.end();) {
+		if (std::find(mapNames.begin(), mapNames.end(), iter->first) == mapNames.end()) { iter = this->loads.erase(iter); }
+		else { ++iter; }
+	}
+
+	for (auto iter = this->finished.begin(); iter != this->finished.end();) {
+		if (std::find(mapNames.begin(), mapNames.end(), iter->first) == mapNames.end()) { iter = this->finished.erase(iter); }
+		else { ++iter; }
+	}
+}
+
+bool LevelPreloader::take(const std::string &mapName, LevelData &data) {
+	const auto finishedIter = this->finished.find(mapName);
+	if (finishedIter != this->finished.end()) {
+		data = std::move(finishedIter->second);
+		this->finished.erase(finishedIter);
+		return true;
+	}
+
+	const auto iter = this->loads.find(mapName);
+	if (iter == this->loads.end()) { return false; }
+
+	std::future<LevelData> load = std::move(iter->second);
+	this->loads.erase(iter);
+
+	try {
+		data = load.get();
+	}
+	catch (...) {
+		return false; // failed loads are retried on the main thread, so errors are reported the same way as before
+	}
+
+	return true;
+}
+
+const LevelData* LevelPreloader::peek(const std::string &mapName) {
+	const auto finishedIter = this->finished.find(mapName);
+	if (finishedIter != this->finished.end()) { return &finishedIter->second; }
+
+	const auto iter = this->loads.find(mapName);
+	if (iter == this->loads.end() || iter->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) { return nullptr; }
+
+	std::future<LevelData> load = std::move(iter->second);
+	this->loads.erase(iter);
+
+	try {
+		return &(this->finished[mapName] = load.get());
+	}
+	catch (...) {
+		return nullptr; // failed loads are retried on the main thread upon level change
+	}
+}
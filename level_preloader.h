@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string> // related type
+#include <vector> // related type
+#include <unordered_map> // related type
+#include <future> // 'std::future' type (background loading)
+
+#include "level_data.h" // 'LevelData' struct
+
+
+
+// # LevelPreloader #
+// - Loads level descriptions of neighbor levels on 'JobSystem' workers
+// - Only the disk reading and parsing happens in background, constructing 'Level' objects
+// still happens on the main thread since it uploads textures and accesses storages
+// - Levels are identified by full map name aka "[name]{version}"
+class LevelPreloader {
+public:
+	LevelPreloader() = default;
+
+	~LevelPreloader(); // waits for all background loads to finish
+
+	void request(const std::string &mapName); // starts loading level in background unless it is already loaded/loading
+	void retain(const std::vector<std::string> &mapNames); // drops all levels that aren't in the list
+
+	bool take(const std::string &mapName, LevelData &data);
+		// moves preloaded level into <data> and returns true, waits if loading isn't finished yet
+		// returns false if level wasn't requested
+
+	const LevelData* peek(const std::string &mapName);
+		// returns preloaded level if its loading has finished, nullptr otherwise (never waits)
+
+private:
+	std::unordered_map<std::string, std::future<LevelData>> loads; // dropping a future doesn't block, discarded loads finish on their own
+	std::unordered_map<std::string, LevelData> finished; // loads that were peeked at are moved here
+};
@@ -4,6 +4,10 @@
 ///#include <stdlib.h> /// CURRENT LEAK IS 16 BYTES
 ///#include <crtdbg.h>
 
+#ifdef HATMAN_HEADLESS
+#define SDL_MAIN_HANDLED // headless build has its own 'main()' and doesn't link SDL
+#endif
+
 #include <iostream> // Text to console (TEMP)
 
 #include "graphics.h" // Has a storage (initialized before start)
@@ -12,12 +16,48 @@
 #include "saver.h" // Has a storage (initialized before start)
 #include "timer.h" // Has a storage (initialized before start)
 #include "controls.h" // Has a storage (initialized before start)
+#include "job_system.h" // Has a storage (initialized before start)
+#include "solid.h" // Has a storage (initialized before start)
 
 #include "launch_info.h" // 'LaunchInfo' class (creation of such object)
 #include "game.h" // 'Game' class
+#include "level_data.h" // level load benchmark (debug command)
+#include "content_archive.h" // Has a storage (initialized before start), packing (debug command)
+#include "tags.h" // tag utility (debug commands)
+#ifdef HATMAN_HEADLESS
+#include "simulation_host.h" // headless instances
+#endif
 
 
 
+#ifdef HATMAN_HEADLESS
+int main(int argc, char* argv[]) {
+	// Headless build has no window, it only runs simulation instances
+	// Arguments: [instance count] [simulated seconds] [savename]
+	const size_t instanceCount = (argc > 1) ? std::stoul(argv[1]) : 2; // several instances by default, so their isolation is checked
+	const double seconds = (argc > 2) ? std::stod(argv[2]) : 60;
+	const std::string savename = (argc > 3) ? argv[3] : "save";
+
+	{
+		// Process-wide storages, instances create the rest on their own threads
+		JobSystem jobs;
+		ContentArchive archive;
+		TilesetStorage tilesets;
+
+		const HostStats stats = SimulationHost("temp/" + savename + ".json").run(instanceCount, seconds * 1000);
+		std::cout
+			<< "$ " << stats.instances << " instances simulated " << seconds << " s each in "
+			<< stats.real_time << " ms (" << stats.speedup << "x real time)" << std::endl;
+
+		if (!stats.isolated) {
+			std::cout << "$ Instances affected each other, timers didn't match simulated time" << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+#else
 int main(int argc, char* argv[]) {
 	std::cout << "Start game in fullscreen mode? (Y/N)" << std::endl;
 	std::string userInput;	
@@ -47,6 +87,15 @@ int main(int argc, char* argv[]) {
 					std::cin >> _savename;
 					std::cout << "$ Savefile selected" << std::endl;
 				}
+				else if (userInput == "/benchlevel") {
+					std::string levelName, levelVersion;
+					std::cin >> levelName >> levelVersion;
+					level_data::benchmark(tags::makeTag(levelName, levelVersion), 50);
+				}
+				else if (userInput == "/pack") {
+					if (ContentArchive::pack("content")) { std::cout << "$ Content packed into '" << ContentArchive::DEFAULT_PATH << "'" << std::endl; }
+					else { std::cout << "$ Packing failed" << std::endl; }
+				}
 			}
 		}
 		else {
@@ -56,11 +105,14 @@ int main(int argc, char* argv[]) {
 
 	{
 		// These objects are storages that can be accessed in any file with a corresponding header included
+		JobSystem jobs; // From now on this object can be accessed through 'JobSystem::ACCESS' (goes first, so it's destroyed last)
+		ContentArchive archive; // From now on this object can be accessed through 'ContentArchive::READ' (falls back to 'content/' if absent)
 		Graphics graphics(launchInfo); // From now on this object can be accessed through 'Graphics::ACCESS'
 		TilesetStorage tilesets; // From now on this object can be accessed through 'TilesetStorage::ACCESS'
 		EmitStorage emits; // From now on this object can be accessed through 'EmitStorage::ACCESS'
+		SolidStorage solids; // From now on this object can be accessed through 'SolidStorage::ACCESS'
 		Saver saver("temp/" + _savename + ".json"); // From now on this object can be accessed through 'Saver::ACCESS'
-		TimerController timerController;
+		TimerController timerController; // From now on this object can be accessed through 'TimerController::ACCESS'
 		Controls controls;
 
 		Game game;
@@ -69,3 +121,4 @@ int main(int argc, char* argv[]) {
 	///_CrtDumpMemoryLeaks(); /// MEMORY LEAK DETECTION
 	return 0;
 }
+#endif
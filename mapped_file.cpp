@@ -0,0 +1,100 @@
+#include "mapped_file.h"
+
+#include <utility> // 'std::swap()'
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h> // 'CreateFileMapping()', 'MapViewOfFile()'
+#else
+#include <sys/mman.h> // 'mmap()', 'munmap()'
+#include <sys/stat.h> // 'fstat()'
+#include <fcntl.h> // 'open()'
+#include <unistd.h> // 'close()'
+#endif
+
+
+
+// # MappedFile #
+MappedFile::MappedFile(const std::string &filePath) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) { return; }
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) { CloseHandle(file); return; }
+
+	this->file_handle = file;
+	this->mapped_size = static_cast<size_t>(fileSize.QuadPart);
+	this->opened = true;
+
+	if (this->mapped_size == 0) { return; } // empty files can't be mapped, but they are still valid files
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping) { this->close(); return; }
+	this->mapping_handle = mapping;
+
+	this->mapped_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!this->mapped_data) { this->close(); return; }
+#else
+	const int file = ::open(filePath.c_str(), O_RDONLY);
+	if (file < 0) { return; }
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0) { ::close(file); return; }
+
+	this->mapped_size = static_cast<size_t>(fileStat.st_size);
+	this->opened = true;
+
+	if (this->mapped_size > 0) { // empty files can't be mapped, but they are still valid files
+		void* mapping = mmap(nullptr, this->mapped_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+		if (mapping == MAP_FAILED) {
+			this->mapped_size = 0;
+			this->opened = false;
+		}
+		else {
+			this->mapped_data = static_cast<const char*>(mapping);
+		}
+	}
+
+	::close(file); // mapping stays valid after descriptor is closed
+#endif
+}
+
+MappedFile::~MappedFile() {
+	this->close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+	*this = std::move(other);
+}
+MappedFile& MappedFile::operator=(MappedFile &&other) noexcept {
+	std::swap(this->mapped_data, other.mapped_data);
+	std::swap(this->mapped_size, other.mapped_size);
+	std::swap(this->opened, other.opened);
+#ifdef _WIN32
+	std::swap(this->file_handle, other.file_handle);
+	std::swap(this->mapping_handle, other.mapping_handle);
+#endif
+	return *this;
+}
+
+bool MappedFile::is_open() const { return this->opened; }
+const char* MappedFile::data() const { return this->mapped_data; }
+size_t MappedFile::size() const { return this->mapped_size; }
+
+void MappedFile::close() {
+#ifdef _WIN32
+	if (this->mapped_data) { UnmapViewOfFile(this->mapped_data); }
+	if (this->mapping_handle) { CloseHandle(this->mapping_handle); }
+	if (this->file_handle) { CloseHandle(this->file_handle); }
+	this->file_handle = nullptr;
+	this->mapping_handle = nullptr;
+#else
+	if (this->mapped_data) { munmap(const_cast<char*>(this->mapped_data), this->mapped_size); }
+#endif
+	this->mapped_data = nullptr;
+	this->mapped_size = 0;
+	this->opened = false;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string> // related type
+
+
+
+// # MappedFile #
+// - Read-only memory mapping of a whole file
+// - Mapping is released upon destruction
+// - Movable, not copyable
+class MappedFile {
+public:
+	MappedFile() = default;
+
+	MappedFile(const std::string &filePath); // maps the file, check 'is_open()' for success
+
+	~MappedFile(); // unmaps the file
+
+	MappedFile(const MappedFile &other) = delete;
+	MappedFile& operator=(const MappedFile &other) = delete;
+
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile& operator=(MappedFile &&other) noexcept;
+
+	bool is_open() const;
+
+	const char* data() const; // returns nullptr for empty/unmapped files
+	size_t size() const;
+
+private:
+	void close();
+
+	const char* mapped_data = nullptr;
+	size_t mapped_size = 0;
+	bool opened = false;
+
+#ifdef _WIN32
+	void* file_handle = nullptr; // 'HANDLE' type
+	void* mapping_handle = nullptr; // 'HANDLE' type
+#endif
+};
\ No newline at end of file
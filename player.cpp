@@ -65,6 +65,10 @@ Vector2d Player::cameraTrapPos() const {
 	return this->cameraTrap;
 }
 
+void Player::resetCameraTrap() {
+	this->cameraTrap = this->position;
+}
+
 
 
 /* ### FORMS ### */
@@ -108,13 +112,8 @@ PlayerForm_Human::PlayerForm_Human(Player &parentPlayer) :
 	this->parent_player.playAnimation("idle");
 
 	// Init solid
-	this->parent_player._init_solid(
+	this->parent_player._init_solid<solid_profiles::Standard>(
 		player_consts::HUMAN_HITBOX_DIMENSIONS,
-		{
-			SolidFlags::SOLID_FOR_TILES,
-			SolidFlags::SOLID_FOR_BORDER,
-			SolidFlags::AFFECTED_BY_GRAVITY
-		},
 		physics::DEFAULT_MASS_PLAYER,
 		physics::DEFAULT_FRICTION_PLAYER
 	);
@@ -155,7 +154,7 @@ void PlayerForm_Human::update(Milliseconds elapsedTime) {
 
 	// GUI
 	if (input.is_KeyPressed(Controls::READ->INVENTORY)) {
-		Graphics::ACCESS->gui->inventoryGUI.toggle();
+		Game::ACCESS->deferGUI([]() { Graphics::ACCESS->gui->inventoryGUI.toggle(); });
 	}
 	if (input.is_KeyPressed(Controls::READ->FORM_CHANGE)) {
 		this->parent_player.playAnimation("idle_nohat");
@@ -164,38 +163,38 @@ void PlayerForm_Human::update(Milliseconds elapsedTime) {
 		// and upon release animation is unlocked
 		// ! visual bugs may arise if player holds the button for over 16 minutes !
 
-		Graphics::ACCESS->gui->FormSelection_on();
+		Game::ACCESS->deferGUI([]() { Graphics::ACCESS->gui->FormSelection_on(); });
 	}
 	else if (input.is_KeyReleased(Controls::READ->FORM_CHANGE)) {
 		this->parent_player.playAnimation("idle");
 		this->parent_player.animation_lock_timer.stop();
 
-		Graphics::ACCESS->gui->FormSelection_off();
+		Game::ACCESS->deferGUI([]() { Graphics::ACCESS->gui->FormSelection_off(); });
 	}
 }
 
 // Movement
 void PlayerForm_Human::runLeft(Milliseconds elapsedTime) {
-	if (parent_player.solid->speed.x > -player_consts::HUMAN_RUNNING_SPEED) {
+	if (parent_player.solid->speed().x > -player_consts::HUMAN_RUNNING_SPEED) {
 		this->parent_player.solid->applyForce(
 			Vector2d(-physics::DEFAULT_MASS_PLAYER * 3000, 0)
 			);
 	}
 	else {
-		parent_player.solid->speed.x = -player_consts::HUMAN_RUNNING_SPEED;
+		parent_player.solid->setSpeed(Vector2d(-player_consts::HUMAN_RUNNING_SPEED, parent_player.solid->speed().y));
 	}
 	
 	this->parent_player.orientation = Orientation::LEFT;
 	this->parent_player.playAnimation("run");
 }
 void PlayerForm_Human::runRight(Milliseconds elapsedTime) {
-	if (parent_player.solid->speed.x < player_consts::HUMAN_RUNNING_SPEED) {
+	if (parent_player.solid->speed().x < player_consts::HUMAN_RUNNING_SPEED) {
 		this->parent_player.solid->applyForce(
 			Vector2d(physics::DEFAULT_MASS_PLAYER * 3000, 0)
 		);
 	}
 	else {
-		parent_player.solid->speed.x = player_consts::HUMAN_RUNNING_SPEED;
+		parent_player.solid->setSpeed(Vector2d(player_consts::HUMAN_RUNNING_SPEED, parent_player.solid->speed().y));
 	}
 
 	this->parent_player.orientation = Orientation::RIGHT;
@@ -205,10 +204,10 @@ void PlayerForm_Human::stopRunning() {
 	this->parent_player.playAnimation("idle");
 }
 void PlayerForm_Human::jump() {
-	if (this->parent_player.solid->isGrounded) {
-		///this->parent_player.solid->speed.y = -player_consts::HUMAN_JUMP_SPEED;
+	if (this->parent_player.solid->isGrounded()) {
+		///this->parent_player.solid->setSpeed(Vector2d(this->parent_player.solid->speed().x, -player_consts::HUMAN_JUMP_SPEED));
 		this->parent_player.solid->applyImpulse(Vector2d(0, -physics::DEFAULT_MASS_PLAYER * player_consts::HUMAN_JUMP_SPEED));
-		this->parent_player.solid->isGrounded = false;
+		this->parent_player.solid->setGrounded(false);
 
 		this->parent_player.form_change_cooldown.start(1000); /// !!! TEMP !!!
 	}
@@ -33,6 +33,7 @@ public:
 	void changeForm(Forms newForm);
 
 	Vector2d cameraTrapPos() const;
+	void resetCameraTrap(); // centers camera trap on the player, used after teleports
 
 	Inventory inventory;
 
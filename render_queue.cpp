@@ -0,0 +1,85 @@
+#include "render_queue.h"
+
+#include <algorithm> // 'std::min()', 'std::max()'
+
+#include "graphics.h" // access to 'SpriteBatch'
+
+
+
+// # RenderQueue #
+void RenderQueue::setLayer(RenderLayer layer, int z) {
+	this->current_layer = layer;
+	this->current_z = static_cast<uint16_t>(std::max(-32768, std::min(z, 32767)) + 32768);
+}
+
+void RenderQueue::record(SDL_Texture* target, SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip) {
+	_render_command command;
+	command.target = target;
+	command.texture = texture;
+	command.has_source = (sourceRect != NULL);
+	command.has_dest = (destRect != NULL);
+	if (sourceRect) { command.source = *sourceRect; }
+	if (destRect) { command.dest = *destRect; }
+	command.angle = angle;
+	command.flip = flip;
+	command.mod = Graphics::READ->batch->getTextureMod(texture);
+
+	// Key => [ 8 unused bits | 8 bits layer | 16 bits z ]
+	const uint32_t key =
+		(static_cast<uint32_t>(this->current_layer) << 16) |
+		static_cast<uint32_t>(this->current_z);
+
+	this->commands.push_back(command);
+	this->keys.push_back(key);
+}
+
+void RenderQueue::submit() {
+	const size_t count = this->commands.size();
+
+	this->order.resize(count);
+	this->order_swap.resize(count);
+	for (size_t i = 0; i < count; ++i) { this->order[i] = static_cast<uint32_t>(i); }
+
+	// LSD radix sort of command indices by key, one byte per pass (stable)
+	const int KEY_BYTES = 3; // only lower 24 bits are used
+	for (int pass = 0; pass < KEY_BYTES; ++pass) {
+		const int shift = pass * 8;
+
+		size_t histogram[256] = {};
+		for (size_t i = 0; i < count; ++i) { ++histogram[(this->keys[i] >> shift) & 0xFF]; }
+
+		if (count == 0 || histogram[(this->keys[0] >> shift) & 0xFF] == count) { continue; } // all keys share this byte
+
+		size_t offset = 0;
+		for (auto &bucket : histogram) {
+			const size_t bucketSize = bucket;
+			bucket = offset;
+			offset += bucketSize;
+		}
+
+		for (const auto index : this->order) { this->order_swap[histogram[(this->keys[index] >> shift) & 0xFF]++] = index; }
+
+		this->order.swap(this->order_swap);
+	}
+
+	// Submit in sorted order
+	for (const auto index : this->order) {
+		const _render_command &command = this->commands[index];
+
+		Graphics::ACCESS->batch->add(
+			command.target, command.texture,
+			command.has_source ? &command.source : NULL,
+			command.has_dest ? &command.dest : NULL,
+			command.angle, command.flip, command.mod
+		);
+	}
+
+	this->commands.clear();
+	this->keys.clear();
+
+	this->setLayer(RenderLayer::TILES); // world drawing starts from tiles
+}
+
+size_t RenderQueue::size() const {
+	return this->commands.size();
+}
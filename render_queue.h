@@ -0,0 +1,71 @@
+#pragma once
+
+#include <SDL.h> // 'SDL_Texture', 'SDL_Rect' and related types
+#include <vector> // related type
+#include <cstdint> // fixed-size types (sort keys)
+
+
+
+// # RenderLayer #
+// - Layers are drawn in order of declaration, regardless of the order of drawing calls
+enum class RenderLayer : uint8_t {
+	TILES,
+	ENTITIES,
+	PLAYER,
+	DEBUG,
+	GUI
+};
+
+
+
+// # _render_command #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Single recorded draw, rects are already converted to target coordinates
+struct _render_command {
+	SDL_Texture* target; // nullptr => renderer itself
+	SDL_Texture* texture;
+
+	SDL_Rect source;
+	SDL_Rect dest;
+	bool has_source; // false => whole texture
+	bool has_dest; // false => whole target
+
+	double angle;
+	SDL_RendererFlip flip;
+
+	SDL_Color mod; // texture mods at the moment of recording
+};
+
+
+
+// # RenderQueue #
+// - Part of 'Graphics' module
+// - Records world, GUI and debug draws of a frame instead of drawing them right away
+// - Each command carries layer, z-order and target, upon submission commands are sorted
+// by (layer, z) and passed to 'SpriteBatch' in that order
+// - Sort is stable, commands with the same layer and z keep the order in which they were recorded,
+// so overlapping draws (GUI fill and border, icons over slots, flickering sprites) keep their order
+// - Commands aren't reordered by texture, 'SpriteBatch' merges adjacent draws of the same texture
+// - Layer and z are set with 'setLayer()' and apply to all following commands
+// - Texture mods are saved upon recording, so changing them right after recording is safe
+class RenderQueue {
+public:
+	void setLayer(RenderLayer layer, int z = 0); // z is clamped to [-32768, 32767]
+
+	void record(SDL_Texture* target, SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle = 0.0, SDL_RendererFlip flip = SDL_FLIP_NONE);
+		// same arguments as 'SpriteBatch::add()'
+
+	void submit(); // sorts recorded commands and passes them to 'SpriteBatch', clears the queue
+
+	size_t size() const; // number of recorded commands
+
+private:
+	RenderLayer current_layer = RenderLayer::TILES;
+	uint16_t current_z = 0; // biased, so unsigned order matches signed one
+
+	std::vector<_render_command> commands;
+	std::vector<uint32_t> keys; // sort key for each command
+
+	std::vector<uint32_t> order; // sort buffers are kept between frames to avoid reallocation
+	std::vector<uint32_t> order_swap;
+};
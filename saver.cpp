@@ -8,8 +8,8 @@
 
 
 // # Saver #
-const Saver* Saver::READ;
-Saver* Saver::ACCESS;
+thread_local const Saver* Saver::READ;
+thread_local Saver* Saver::ACCESS;
 
 Saver::Saver(const std::string &filePath) :
 	save_filepath(filePath)
@@ -23,6 +23,10 @@ Saver::Saver(const std::string &filePath) :
 	
 }
 
+Saver::~Saver() {
+	JobSystem::ACCESS->wait(this->last_save);
+}
+
 void Saver::makeNewSave() {
 	const std::string firstLevel = "GrayBricks_1";
 	const Vector2d playerSpawnpoint(100, 240);
@@ -37,9 +41,12 @@ void Saver::makeNewSave() {
 }
 
 void Saver::save() {
-	std::ofstream file(this->save_filepath);
-	file << std::setw(4) << this->state; // setw() pretifies JSON so it is no a single line
-	file.close();
+	// State is copied, so the game can keep changing it while the copy is written
+	this->last_save = JobSystem::ACCESS->submit([state = this->state, path = this->save_filepath]() {
+		std::ofstream file(path);
+		file << std::setw(4) << state; // setw() pretifies JSON so it is no a single line
+		file.close();
+	}, { this->last_save });
 }
 
 // Recorders
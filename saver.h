@@ -4,19 +4,23 @@
 #include "nlohmann_external.hpp" // parsing from JSON, 'nlohmann::json' type
 
 #include "geometry_utils.h" // geometry types
+#include "job_system.h" // 'JobHandle' type (background saving)
 
 
 
 // # Saver #
-// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields
+// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields (per instance, see 'InstanceContext')
 // - Opens save files
 // - Records and saves game progress
+// - Serialization and writing of savefile happen on 'JobSystem' workers, saves are written in order they were made
 class Saver {
 public:
 	Saver(const std::string &filePath = "temp/save.json"); // takes filepath to savefile
 
-	static const Saver* READ; // used for aka 'global' access
-	static Saver* ACCESS;
+	~Saver(); // waits for the last save to be written
+
+	static thread_local const Saver* READ; // used for aka 'global' access
+	static thread_local Saver* ACCESS;
 
 	void makeNewSave();
 	void save();
@@ -32,4 +36,6 @@ private:
 	nlohmann::json state;
 
 	std::string save_filepath;
+
+	JobHandle last_save; // next save depends on it, so older state never overwrites the newer one
 };
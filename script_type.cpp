@@ -21,7 +21,7 @@ void scripts::LevelChange::trigger() {
 	if (!Game::ACCESS->levelChangeInProgress()) {
 		const int FADE_DURATION = 500;
 
-		Graphics::ACCESS->gui->Fade_on(colors::BLACK.transparent(), colors::BLACK, FADE_DURATION);
+		Game::ACCESS->deferGUI([]() { Graphics::ACCESS->gui->Fade_on(colors::BLACK.transparent(), colors::BLACK, FADE_DURATION); });
 
 		Game::ACCESS->changeLevel(this->goes_to_level, this->goes_to_pos, FADE_DURATION);
 	}
@@ -45,7 +45,7 @@ void scripts::LevelSwitch::trigger() {
 	if (!Game::ACCESS->levelChangeInProgress()) {
 		const int FADE_DURATION = 500;
 
-		Graphics::ACCESS->gui->Fade_on(colors::BLACK.transparent(), colors::BLACK, FADE_DURATION);
+		Game::ACCESS->deferGUI([]() { Graphics::ACCESS->gui->Fade_on(colors::BLACK.transparent(), colors::BLACK, FADE_DURATION); });
 
 		Game::ACCESS->changeLevel(this->goes_to_level, this->goes_to_pos, FADE_DURATION);
 	}
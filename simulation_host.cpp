@@ -0,0 +1,80 @@
+// Headless build only, windowed 'Game' can't be run without input and rendering
+#ifdef HATMAN_HEADLESS
+#include "simulation_host.h"
+
+#include <thread> // 'std::thread' type (instances)
+#include <functional> // 'std::ref()'
+#include <vector> // related type
+#include <chrono> // timing of the run
+#include <filesystem> // copying savefiles
+#include <cmath> // 'std::floor()', 'std::abs()' (isolation check)
+
+#include "launch_info.h" // 'LaunchInfo' class (required by 'Graphics')
+#include "graphics.h" // instance storages
+#include "emit.h"
+#include "solid.h"
+#include "saver.h"
+#include "controls.h"
+#include "timer.h"
+#include "game.h"
+
+
+
+// # SimulationHost #
+SimulationHost::SimulationHost(const std::string &saveFilePath) :
+	save_filepath(saveFilePath)
+{}
+
+HostStats SimulationHost::run(size_t instanceCount, Milliseconds simulatedTime) {
+	const auto start = std::chrono::steady_clock::now();
+
+	std::vector<Milliseconds> timerTimes(instanceCount, 0);
+
+	std::vector<std::thread> instances;
+	for (size_t i = 0; i < instanceCount; ++i) {
+		instances.emplace_back(&SimulationHost::run_Instance, this, i, simulatedTime, std::ref(timerTimes[i]));
+	}
+	for (auto &instance : instances) { instance.join(); }
+
+	HostStats stats;
+	stats.instances = instanceCount;
+	stats.simulated_time = simulatedTime;
+	stats.real_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	stats.speedup = stats.real_time > 0 ? instanceCount * simulatedTime / stats.real_time : 0;
+
+	// Instance simulates whole steps only, its timers should've seen exactly these steps and nothing else
+	const Milliseconds expectedTime = std::floor(simulatedTime / Game::SIMULATION_STEP) * Game::SIMULATION_STEP;
+
+	stats.isolated = true;
+	for (const auto time : timerTimes) {
+		if (std::abs(time - expectedTime) > Game::SIMULATION_STEP / 2) { stats.isolated = false; }
+	}
+
+	return stats;
+}
+
+void SimulationHost::run_Instance(size_t index, Milliseconds simulatedTime, Milliseconds &timerTime) const {
+	// Each instance works with its own copy of the savefile, missing savefile => instance makes a new one
+	const std::filesystem::path source(this->save_filepath);
+	const std::string instanceSave = (source.parent_path() / (source.stem().string() + "_instance" + std::to_string(index) + source.extension().string())).string();
+
+	std::error_code error; // failures are handled by 'Saver'
+	std::filesystem::remove(instanceSave, error);
+	std::filesystem::copy_file(source, instanceSave, error);
+
+	LaunchInfo launchInfo; // window settings aren't used by headless 'Graphics'
+
+	// Same storages as in 'main()', they are bound to this thread
+	Graphics graphics(launchInfo);
+	EmitStorage emits;
+	SolidStorage solids;
+	Saver saver(instanceSave);
+	Controls controls;
+	TimerController timers;
+
+	Game game(simulatedTime); // returns once simulation is over
+
+	timerTime = timers.time();
+}
+
+#endif // HATMAN_HEADLESS
\ No newline at end of file
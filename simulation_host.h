@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string> // related type
+#include <vector> // related type
+
+#include "timer.h" // 'Milliseconds' type
+
+
+
+// # HostStats #
+// - Results of a single 'SimulationHost::run()'
+struct HostStats {
+	size_t instances = 0;
+	Milliseconds simulated_time = 0; // per instance
+	Milliseconds real_time = 0; // time the whole run took
+	double speedup = 0; // simulated time of all instances divided by real time
+	bool isolated = false; // every instance advanced its timers by exactly its own simulated time
+};
+
+
+
+// # SimulationHost #
+// - Runs several independent headless game instances at once, each one on its own thread, as fast as possible
+// - Only exists in headless build (HATMAN_HEADLESS defined), where 'Graphics' doesn't touch SDL
+// - Every instance creates its own storages ('Graphics', 'EmitStorage', 'SolidStorage', 'Saver',
+// 'Controls', 'TimerController' and 'Game'), process-wide storages have to exist already (see 'InstanceContext')
+// - Instances start from copies of the same savefile, so their saves don't interfere
+// - Each run checks that instances didn't affect each other, an instance advancing timers of another one
+// would show up as timer time different from simulated time ('HostStats::isolated')
+// - Used for bot testing and as a base for servers
+class SimulationHost {
+public:
+	SimulationHost(const std::string &saveFilePath); // instances start from this savefile
+
+	HostStats run(size_t instanceCount, Milliseconds simulatedTime);
+		// returns once all instances are finished
+
+private:
+	void run_Instance(size_t index, Milliseconds simulatedTime, Milliseconds &timerTime) const; // <timerTime> receives time of instance timers
+
+	std::string save_filepath;
+};
@@ -2,6 +2,7 @@
 
 #include "graphics.h" // access to texture loading
 #include "game.h" // access to the game state
+#include "effect_buffer.h" // deferring effects on other entities (parallel entity updates)
 
 
 
@@ -185,8 +186,8 @@ void skills::KnockbackAOE::use() {
 	auto targetRelativePos = this->parent_creature->position - player->position;
 
 	if (targetRelativePos.length2() < RADIUS * RADIUS) {
-		player->solid->applyImpulse(
-			Vector2d(-helpers::sign(targetRelativePos.x) * player->solid->mass * 200, player->solid->mass * -150)
-		);
+		const Vector2d impulse(-helpers::sign(targetRelativePos.x) * player->solid->getMass() * 200, player->solid->getMass() * -150);
+
+		EffectBuffer::defer([impulse]() { Game::ACCESS->level.player->solid->applyImpulse(impulse); }); // player isn't ours to touch during entity updates
 	}
 }
\ No newline at end of file
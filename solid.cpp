@@ -1,112 +1,348 @@
 #include "solid.h"
 
+#include <vector> // related type (collision candidates)
+#include <cstdint> // 'SIZE_MAX' macro
+#include <algorithm> // 'std::min()', 'std::max()' (swept search area)
+#include <cassert> // creation checks
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h> // SSE2 intrinsics (integration)
+#define SOLID_USE_SSE2
+#endif
+
 #include "game.h" // access to timescale and game state
 #include "globalconsts.hpp" // contains tile size (used in tile collision detection)
+#include "hitbox_grid.h" // tile hitbox broadphase
+#include "job_system.h" // parallel collision resolution
+#include "effect_buffer.h" // creation checks
 
 
 
-// # Entity::Physics #
-SolidRectangle::SolidRectangle(Vector2d &parentPosition, const Vector2 &hitboxSize, const std::initializer_list<SolidFlags> &flags, double mass = 1, double friction = 0) :
-	parent_position(parentPosition),
-	hitboxSize(hitboxSize),
-	flags(flags),
-	mass(mass),
-	friction(friction),
-	isGrounded(false),
-	total_force(0, 0)
-{}
+// # _solid_storage #
+uint32_t _solid_storage::add(Vector2d &parentPosition, const Vector2 &hitboxSize, double mass, double friction) {
+	uint32_t id = this->free_slot;
 
-void SolidRectangle::update(Milliseconds elapsedTime) {
-	// Apply forces
-	if (this->flags.count(SolidFlags::AFFECTED_BY_GRAVITY)) { this->apply_Gravity(); }
-	if (this->isGrounded) { this->apply_Friction(); }
+	if (id != UINT32_MAX) {
+		this->free_slot = this->slots[id];
+	}
+	else {
+		id = static_cast<uint32_t>(this->slots.size());
+		this->slots.push_back(0);
+	}
 
-	// Apply position change
-	this->acceleration = this->total_force / this->mass;
-	this->total_force = Vector2d(0, 0);
+	this->slots[id] = static_cast<uint32_t>(this->size());
+
+	this->position.push_back(parentPosition);
+	this->speed.push_back(Vector2d(0, 0));
+	this->force.push_back(Vector2d(0, 0));
+	this->mass.push_back(mass);
+	this->inv_mass.push_back(1. / mass);
+	this->friction.push_back(friction);
+	this->hitbox_size.push_back(hitboxSize);
+	this->grounded.push_back(0);
+	this->active.push_back(0);
+	this->parent.push_back(&parentPosition);
+	this->owner.push_back(id);
+
+	return id;
+}
+
+void _solid_storage::remove(uint32_t id) {
+	const size_t index = this->slots[id];
+	const size_t last = this->size() - 1;
+
+	// Move last body into the gap
+	if (index != last) {
+		this->position[index] = this->position[last];
+		this->speed[index] = this->speed[last];
+		this->force[index] = this->force[last];
+		this->mass[index] = this->mass[last];
+		this->inv_mass[index] = this->inv_mass[last];
+		this->friction[index] = this->friction[last];
+		this->hitbox_size[index] = this->hitbox_size[last];
+		this->grounded[index] = this->grounded[last];
+		this->active[index] = this->active[last];
+		this->parent[index] = this->parent[last];
+		this->owner[index] = this->owner[last];
+
+		this->slots[this->owner[index]] = static_cast<uint32_t>(index);
+	}
+
+	this->position.pop_back();
+	this->speed.pop_back();
+	this->force.pop_back();
+	this->mass.pop_back();
+	this->inv_mass.pop_back();
+	this->friction.pop_back();
+	this->hitbox_size.pop_back();
+	this->grounded.pop_back();
+	this->active.pop_back();
+	this->parent.pop_back();
+	this->owner.pop_back();
+
+	this->slots[id] = this->free_slot;
+	this->free_slot = id;
+}
+
+size_t _solid_storage::size() const {
+	return this->owner.size();
+}
+
+
+
+// # SolidRectangle #
+
+SolidRectangle::SolidRectangle(uint8_t profile, Vector2d &parentPosition, const Vector2 &hitboxSize, double mass, double friction) :
+	profile(profile),
+	body(SolidStorage::ACCESS->groups[profile].add(parentPosition, hitboxSize, mass, friction))
+{
+	assert(!EffectBuffer::deferring() && "Solids can't be created during parallel entity updates, defer the spawn");
+}
 
-	this->speed += this->acceleration * per_second(elapsedTime);
-	this->parent_position += this->speed * per_second(elapsedTime);	
+SolidRectangle::~SolidRectangle() {
+	assert(!EffectBuffer::deferring() && "Solids can't be destroyed during parallel entity updates");
 
-	// Apply interaction with objects
-	if (this->flags.count(SolidFlags::SOLID_FOR_TILES)) { this->apply_TileCollisions(); }
-	if (this->flags.count(SolidFlags::SOLID_FOR_BORDER)) { this->apply_LevelBorderCollisions(); }
+	this->group().remove(this->body);
+}
+
+void SolidRectangle::activate() {
+	this->group().active[this->index()] = 1;
+}
+
+void SolidRectangle::updateAll(Milliseconds elapsedTime) {
+	update_Profiles(elapsedTime, std::make_integer_sequence<uint8_t, PROFILE_COUNT>());
 }
 
 Rectangle SolidRectangle::getHitbox() const {
-	return Rectangle(parent_position.toVector2(), this->hitboxSize, true);
+	return Rectangle(this->group().parent[this->index()]->toVector2(), this->group().hitbox_size[this->index()], true);
+}
+
+Vector2d SolidRectangle::speed() const {
+	return this->group().speed[this->index()];
+}
+void SolidRectangle::setSpeed(const Vector2d &speed) {
+	this->group().speed[this->index()] = speed;
 }
 
 void SolidRectangle::applyForce(const Vector2d &force) {
-	this->total_force += force;
+	this->group().force[this->index()] += force;
 }
 void SolidRectangle::applyImpulse(const Vector2d &impulse) {
-	this->speed += impulse / this->mass;
+	this->group().speed[this->index()] += impulse * this->group().inv_mass[this->index()];
+}
+
+double SolidRectangle::getMass() const {
+	return this->group().mass[this->index()];
+}
+double SolidRectangle::getFriction() const {
+	return this->group().friction[this->index()];
+}
+
+bool SolidRectangle::isGrounded() const {
+	return this->group().grounded[this->index()];
+}
+void SolidRectangle::setGrounded(bool grounded) {
+	this->group().grounded[this->index()] = grounded;
+}
+
+_solid_storage& SolidRectangle::group() const {
+	return SolidStorage::ACCESS->groups[this->profile];
+}
+size_t SolidRectangle::index() const {
+	return SolidStorage::ACCESS->groups[this->profile].slots[this->body];
+}
+
+template<uint8_t... Profiles>
+void SolidRectangle::update_Profiles(Milliseconds elapsedTime, std::integer_sequence<uint8_t, Profiles...>) {
+	(update_Profile<Profiles>(elapsedTime), ...);
+}
+
+template<uint8_t Profile>
+void SolidRectangle::update_Profile(Milliseconds elapsedTime) {
+	constexpr bool gravity = Profile & solid_flag_bit(SolidFlags::AFFECTED_BY_GRAVITY);
+	constexpr bool tiles = Profile & solid_flag_bit(SolidFlags::SOLID_FOR_TILES);
+	constexpr bool border = Profile & solid_flag_bit(SolidFlags::SOLID_FOR_BORDER);
+
+	_solid_storage &group = SolidStorage::ACCESS->groups[Profile];
+	if (!group.size()) { return; }
+
+	// Apply forces
+	apply_Forces<gravity>(group);
+
+	// Apply position change
+	integrate(group, elapsedTime);
+
+	// Apply interaction with objects, write results back (bodies only touch their own state, so they are split between workers)
+	JobSystem::ACCESS->parallelFor(group.size(), COLLISION_GRAIN_SIZE, [&group](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			if (!group.active[i]) { continue; }
+
+			if constexpr (tiles) { apply_TileCollisions(group, i); }
+			if constexpr (border) { apply_LevelBorderCollisions(group, i); }
+
+			*group.parent[i] = group.position[i];
+			group.active[i] = 0;
+		}
+	});
 }
 
-void SolidRectangle::apply_Gravity() {
-	//this->speed.y += per_second(physics::GRAVITY_ACCELERATION) * elapsedTime;
-	this->applyForce(Vector2d(0, this->mass * physics::GRAVITY_ACCELERATION));
+template<bool Gravity>
+void SolidRectangle::apply_Forces(_solid_storage &group) {
+	for (size_t i = 0; i < group.size(); ++i) {
+		if (!group.active[i]) { continue; }
+
+		group.position[i] = *group.parent[i]; // parent could've been moved outside of physics (level changes, etc)
+
+		// Gravity
+		if constexpr (Gravity) { group.force[i].y += group.mass[i] * physics::GRAVITY_ACCELERATION; }
+
+		// Friction
+		if (group.grounded[i]) {
+			if (std::abs(group.speed[i].x) < 2) group.speed[i].x = 0; // ensures speed converges at 0 due to friction
+
+			group.force[i].x -= helpers::sign(group.speed[i].x) * group.mass[i] * physics::GRAVITY_ACCELERATION * group.friction[i];
+		}
+	}
 }
-void SolidRectangle::apply_Friction() {
-	if (std::abs(this->speed.x) < 2) this->speed.x = 0; // ensures speed converges at 0 due to friction
 
-	this->applyForce(Vector2d(
-		-helpers::sign(this->speed.x) * this->mass * physics::GRAVITY_ACCELERATION * this->friction,
-		0
-	));
+void SolidRectangle::integrate(_solid_storage &group, Milliseconds elapsedTime) {
+	// Branchless pass over all bodies, inactive ones are integrated over zero time and keep their accumulated force
+	const double time = per_second(elapsedTime);
+	const size_t count = group.size();
+	if (!count) { return; }
+
+#ifdef SOLID_USE_SSE2
+	static_assert(sizeof(Vector2d) == 2 * sizeof(double), "'Vector2d' is loaded as a pair of doubles");
+
+	double* const position = &group.position.data()->x;
+	double* const speed = &group.speed.data()->x;
+	double* const force = &group.force.data()->x;
+
+	// One body per register, x and y are integrated together
+	for (size_t i = 0; i < count; ++i) {
+		const double active = group.active[i];
+		const __m128d step = _mm_set1_pd(time * active);
+
+		const __m128d f = _mm_loadu_pd(force + 2 * i);
+		const __m128d a = _mm_mul_pd(f, _mm_set1_pd(group.inv_mass[i]));
+		const __m128d v = _mm_add_pd(_mm_loadu_pd(speed + 2 * i), _mm_mul_pd(a, step));
+		const __m128d p = _mm_add_pd(_mm_loadu_pd(position + 2 * i), _mm_mul_pd(v, step));
+
+		_mm_storeu_pd(speed + 2 * i, v);
+		_mm_storeu_pd(position + 2 * i, p);
+		_mm_storeu_pd(force + 2 * i, _mm_mul_pd(f, _mm_set1_pd(1. - active)));
+	}
+#else
+	for (size_t i = 0; i < count; ++i) {
+		const double active = group.active[i];
+		const double step = time * active;
+
+		const Vector2d acceleration = group.force[i] * group.inv_mass[i];
+
+		group.speed[i] += acceleration * step;
+		group.position[i] += group.speed[i] * step;
+		group.force[i] *= 1. - active;
+	}
+#endif
 }
-void SolidRectangle::apply_TileCollisions() {
+
+void SolidRectangle::apply_TileCollisions(_solid_storage &group, size_t body) {
+	Vector2d &position = group.position[body];
+	Vector2d &speed = group.speed[body];
+	const Vector2 &hitboxSize = group.hitbox_size[body];
+
+	const auto getHitbox = [&]() { return Rectangle(position.toVector2(), hitboxSize, true); };
+
 	bool collidedAtBottom = false;
 
-	for (const auto &tile : Game::ACCESS->level.tiles) {
-		if (tile.hitbox) { // no need to handle if tile has no hitbox
-			const Rectangle entityHitbox = this->getHitbox();
-
-			for (const auto& hitboxRect : tile.hitbox->rectangles) {
-				if (entityHitbox.overlapsWithRect(hitboxRect)) {
-					const Side collisionSide = entityHitbox.getCollisionSide(hitboxRect);
-		 			
-					if (collisionSide == Side::BOTTOM) { // This case goes first as the most likely
-						parent_position.y = (double)hitboxRect.getSide(Side::TOP) - ((double)entityHitbox.getDimensions().y / 2.0);
-						collidedAtBottom = true;
-						this->speed.y = 0.0;
-					}
-					else if (collisionSide == Side::TOP) {
-						parent_position.y = (double)hitboxRect.getSide(Side::BOTTOM) + ((double)entityHitbox.getDimensions().y / 2.0) + 1.0;
-						this->speed.y = 0.0;
-					}
-					else if (collisionSide == Side::LEFT) {
-						parent_position.x = (double)hitboxRect.getSide(Side::RIGHT) + ((double)entityHitbox.getDimensions().x / 2.0) + 1.0;
-						this->speed.x = 0.0;
-					}
-					else if (collisionSide == Side::RIGHT) {
-						parent_position.x = (double)hitboxRect.getSide(Side::LEFT) - ((double)entityHitbox.getDimensions().x / 2.0) - 1.0;
-						this->speed.x = 0.0;
-					}
+	// Search area is the hitbox swept from the position before integration (parent isn't written back yet)
+	// to the current one, extended by a tile to cover positions solid can be pushed to while resolving collisions
+	const Rectangle previousHitbox(group.parent[body]->toVector2(), hitboxSize, true);
+	const Rectangle currentHitbox = getHitbox();
+
+	const int MARGIN = rendering::TILE_SIZE;
+	const int left = std::min(previousHitbox.getSide(Side::LEFT), currentHitbox.getSide(Side::LEFT)) - MARGIN;
+	const int top = std::min(previousHitbox.getSide(Side::TOP), currentHitbox.getSide(Side::TOP)) - MARGIN;
+	const int right = std::max(previousHitbox.getSide(Side::RIGHT), currentHitbox.getSide(Side::RIGHT)) + MARGIN;
+	const int bottom = std::max(previousHitbox.getSide(Side::BOTTOM), currentHitbox.getSide(Side::BOTTOM)) + MARGIN;
+
+	const Rectangle searchArea(left, top, right - left, bottom - top);
+
+	std::vector<const HitboxGrid*> grids; // every loaded chunk has its own grid
+	Game::ACCESS->level.getHitboxGrids(searchArea, grids);
+
+	std::vector<size_t> candidates;
+
+	for (const auto grid : grids) {
+		grid->query(searchArea, candidates);
+
+		Rectangle entityHitbox = getHitbox();
+		size_t currentGroup = SIZE_MAX;
+
+		for (const auto index : candidates) {
+			// Hitbox is recalculated once per tile (rectangles of the same tile use the same hitbox)
+			if (grid->getGroup(index) != currentGroup) {
+				currentGroup = grid->getGroup(index);
+				entityHitbox = getHitbox();
+			}
+
+			const Rectangle &hitboxRect = grid->getRect(index);
+
+			if (entityHitbox.overlapsWithRect(hitboxRect)) {
+				const Side collisionSide = entityHitbox.getCollisionSide(hitboxRect);
+
+				if (collisionSide == Side::BOTTOM) { // This case goes first as the most likely
+					position.y = (double)hitboxRect.getSide(Side::TOP) - ((double)entityHitbox.getDimensions().y / 2.0);
+					collidedAtBottom = true;
+					speed.y = 0.0;
+				}
+				else if (collisionSide == Side::TOP) {
+					position.y = (double)hitboxRect.getSide(Side::BOTTOM) + ((double)entityHitbox.getDimensions().y / 2.0) + 1.0;
+					speed.y = 0.0;
+				}
+				else if (collisionSide == Side::LEFT) {
+					position.x = (double)hitboxRect.getSide(Side::RIGHT) + ((double)entityHitbox.getDimensions().x / 2.0) + 1.0;
+					speed.x = 0.0;
+				}
+				else if (collisionSide == Side::RIGHT) {
+					position.x = (double)hitboxRect.getSide(Side::LEFT) - ((double)entityHitbox.getDimensions().x / 2.0) - 1.0;
+					speed.x = 0.0;
 				}
 			}
 		}
 	}
 
-	this->isGrounded = collidedAtBottom;
+	group.grounded[body] = collidedAtBottom;
 }
-void SolidRectangle::apply_LevelBorderCollisions() {
-	const Rectangle entityHitbox = this->getHitbox();
+void SolidRectangle::apply_LevelBorderCollisions(_solid_storage &group, size_t body) {
+	Vector2d &position = group.position[body];
+
+	const Rectangle entityHitbox(position.toVector2(), group.hitbox_size[body], true);
 	const int levelWidth = Game::ACCESS->level.getSize().x * rendering::TILE_SIZE; // Assumes rendering size is equal to physica;
 	const int levelHeight = Game::ACCESS->level.getSize().y * rendering::TILE_SIZE;
 
 	if (entityHitbox.getSide(Side::LEFT) < 0) {
-		parent_position.x = entityHitbox.getDimensions().x / 2.0;
+		position.x = entityHitbox.getDimensions().x / 2.0;
 	}
 	else if (entityHitbox.getSide(Side::RIGHT) > levelWidth) {
-		parent_position.x = levelWidth - entityHitbox.getDimensions().x / 2.0;
+		position.x = levelWidth - entityHitbox.getDimensions().x / 2.0;
 	}
 
 	if (entityHitbox.getSide(Side::TOP) < 0) {
-		parent_position.y = entityHitbox.getDimensions().y / 2.0;
+		position.y = entityHitbox.getDimensions().y / 2.0;
 	}
 	else if (entityHitbox.getSide(Side::BOTTOM) > levelHeight) {
-		parent_position.y = levelHeight - entityHitbox.getDimensions().y / 2.0;
+		position.y = levelHeight - entityHitbox.getDimensions().y / 2.0;
 	}
+}
+
+
+
+// # SolidStorage #
+thread_local const SolidStorage* SolidStorage::READ;
+thread_local SolidStorage* SolidStorage::ACCESS;
+
+SolidStorage::SolidStorage() {
+	this->READ = this;
+	this->ACCESS = this;
 }
\ No newline at end of file
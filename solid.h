@@ -1,6 +1,8 @@
 #pragma once
 
-#include <unordered_set> // related type
+#include <vector> // related type (physics storage)
+#include <cstdint> // fixed-size types (flags, body ids)
+#include <utility> // 'std::integer_sequence' type (iterating over profiles)
 
 #include "timer.h" // 'Milliseconds' type
 #include "geometry_utils.h" // geometry types
@@ -15,45 +17,133 @@ enum class SolidFlags {
 	AFFECTED_BY_GRAVITY
 };
 
+constexpr uint8_t solid_flag_bit(SolidFlags flag) {
+	return static_cast<uint8_t>(1 << static_cast<int>(flag));
+}
+
+
+
+// # SolidProfile<> #
+// - Set of flags fixed at compile time, determines which physics steps are applied to the solid
+// - Solids with the same profile are stored and simulated together, checks of flags are resolved during compilation
+template<SolidFlags... Flags>
+struct SolidProfile {
+	static constexpr uint8_t MASK = (0 | ... | solid_flag_bit(Flags));
+};
+
+namespace solid_profiles {
+	using Standard = SolidProfile<SolidFlags::AFFECTED_BY_GRAVITY, SolidFlags::SOLID_FOR_TILES, SolidFlags::SOLID_FOR_BORDER>;
+		// walks on tiles, used by items, destructibles, most creatures and the player
+	using Flying = SolidProfile<SolidFlags::SOLID_FOR_BORDER>;
+		// ignores gravity and tiles, stays inside the level
+}
+
+
+
+// # _solid_storage #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Physics state of all solids in structure-of-arrays layout, every array has one element per body
+// - Bodies are kept dense (removed body is replaced by the last one), 'slots' map stable body ids to indices
+// - There is a separate storage for every 'SolidProfile<>', so flags aren't stored at all
+struct _solid_storage {
+	std::vector<Vector2d> position; // copy of parent position, only valid during the physics pass
+	std::vector<Vector2d> speed;
+	std::vector<Vector2d> force; // accumulated until the next pass body is active in
+	std::vector<double> mass;
+	std::vector<double> inv_mass; // integration multiplies instead of dividing
+	std::vector<double> friction;
+	std::vector<Vector2> hitbox_size;
+	std::vector<uint8_t> grounded;
+	std::vector<uint8_t> active; // set by 'SolidRectangle::activate()', reset after every pass
+	std::vector<Vector2d*> parent; // position of the object body is attached to
+	std::vector<uint32_t> owner; // id of each body
+
+	std::vector<uint32_t> slots; // body id => index if body exists, next free id otherwise
+	uint32_t free_slot = UINT32_MAX;
+
+	uint32_t add(Vector2d &parentPosition, const Vector2 &hitboxSize, double mass, double friction); // returns body id
+	void remove(uint32_t id);
+
+	size_t size() const;
+};
+
 
 
 // # SolidRectangle #
 // - Represents a rectangle with physics attached to it
-// - Behaviour depends on active flags
+// - Behaviour depends on the profile (set of flags) given upon construction
+// - Physics state lives in 'SolidStorage' of the instance, physics of all solids is resolved in a single pass by 'updateAll()',
+// gravity, friction and integration run over contiguous arrays (SSE2 when available), results are written back into parents
+// - Solids can only be created and destroyed outside of parallel entity updates (spawns go through 'EffectBuffer::defer()'),
+// creation grows storage arrays that other tasks read
 class SolidRectangle {
 public:
-	
-
 	SolidRectangle() = delete;
 
-	SolidRectangle(Vector2d &parentPosition, const Vector2 &hitboxSize, const std::initializer_list<SolidFlags> &flags, double mass, double friction);
+	template<class Profile>
+	SolidRectangle(Profile, Vector2d &parentPosition, const Vector2 &hitboxSize, double mass = 1, double friction = 0) :
+		SolidRectangle(Profile::MASK, parentPosition, hitboxSize, mass, friction)
+	{}
+
+	~SolidRectangle(); // removes body from the storage
 
-	void update(Milliseconds elapsedTime);
+	SolidRectangle(const SolidRectangle &other) = delete;
+	SolidRectangle& operator=(const SolidRectangle &other) = delete;
 
-	Rectangle getHitbox() const;
+	void activate(); // body will be simulated by the next 'updateAll()', solids that weren't activated stay frozen
 
-	Vector2 hitboxSize; // hitbox rectangle with a center in parent_position
+	static void updateAll(Milliseconds elapsedTime); // applies forces, integrates and resolves collisions of all activated solids
 
-	Vector2d &parent_position; // position of the object module is attached to
-	Vector2d speed;
-	Vector2d acceleration; // acceleration not accounting for constants aka gravity
+	Rectangle getHitbox() const; // hitbox rectangle with a center in parent position
+
+	Vector2d speed() const;
+	void setSpeed(const Vector2d &speed);
 
 	void applyForce(const Vector2d &force);
 	void applyImpulse(const Vector2d &impulse);
 
 	// Properties
-	double mass;
-	double friction; // slows down grounded objects horizontaly by its value per second
+	double getMass() const;
+	double getFriction() const; // slows down grounded objects horizontaly by its value per second
+
+	bool isGrounded() const;
+	void setGrounded(bool grounded);
 
-	bool isGrounded;
+	static const size_t PROFILE_COUNT = 1 << 3; // number of possible flag combinations
+	static const size_t COLLISION_GRAIN_SIZE = 64; // bodies per parallel collision task
 
 private:
-	Vector2d total_force;
-	
-	void apply_Gravity(); // applies gravity force
-	void apply_Friction(); // applies friction force
-	void apply_TileCollisions();
-	void apply_LevelBorderCollisions();
-
-	std::unordered_set<SolidFlags> flags;
-};
\ No newline at end of file
+	SolidRectangle(uint8_t profile, Vector2d &parentPosition, const Vector2 &hitboxSize, double mass, double friction);
+
+	_solid_storage& group() const; // storage of the solid profile
+	size_t index() const; // current position of the body in its storage
+
+	template<uint8_t... Profiles>
+	static void update_Profiles(Milliseconds elapsedTime, std::integer_sequence<uint8_t, Profiles...>);
+	template<uint8_t Profile>
+	static void update_Profile(Milliseconds elapsedTime); // physics pass specialized for a combination of flags
+
+	template<bool Gravity>
+	static void apply_Forces(_solid_storage &group); // applies gravity and friction forces
+	static void integrate(_solid_storage &group, Milliseconds elapsedTime);
+	static void apply_TileCollisions(_solid_storage &group, size_t body); // <body> is an index in storage
+	static void apply_LevelBorderCollisions(_solid_storage &group, size_t body);
+
+	uint8_t profile; // mask of the profile
+	uint32_t body; // id in the storage of the profile
+};
+
+
+
+// # SolidStorage #
+// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields (per instance, see 'InstanceContext')
+// - Holds physics state of all solids of a game instance
+class SolidStorage {
+public:
+	SolidStorage();
+
+	static thread_local const SolidStorage* READ; // used for aka 'global' access
+	static thread_local SolidStorage* ACCESS;
+
+	_solid_storage groups[SolidRectangle::PROFILE_COUNT]; // indexed by profile mask
+};
@@ -71,11 +71,9 @@ StaticSprite::StaticSprite(
 	Sprite(spritesheet, parentPosition, centered, overlay)
 {
 	// Deduce texture size
-	int textureWidth;
-	int textureHeight;
-	SDL_QueryTexture(this->spritesheet, NULL, NULL, &textureWidth, &textureHeight);
+	const Vector2 textureSize = Graphics::READ->getTextureSize(this->spritesheet);
 
-	this->source_rect = { 0, 0, textureWidth, textureHeight };
+	this->source_rect = { 0, 0, textureSize.x, textureSize.y };
 }
 
 StaticSprite::StaticSprite(
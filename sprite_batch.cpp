@@ -0,0 +1,195 @@
+// Left out of headless build, see 'graphics_headless.cpp'
+#ifndef HATMAN_HEADLESS
+
+#include "sprite_batch.h"
+
+#include <cmath> // 'std::sin()', 'std::cos()'
+#include <utility> // 'std::swap()'
+
+#include "globalconsts.hpp" // rendering size (drawing to renderer with NULL destination)
+#include "graphics.h" // access to 'TextureAtlas'
+
+
+
+// # SpriteBatch #
+SpriteBatch::SpriteBatch(SDL_Renderer* renderer) :
+	renderer(renderer)
+{}
+
+void SpriteBatch::add(SDL_Texture* target, SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip) {
+	this->add(target, texture, sourceRect, destRect, angle, flip, this->getTextureMod(texture));
+}
+void SpriteBatch::add(SDL_Texture* target, SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip, const SDL_Color &mod) {
+	// Atlas handle => region of atlas page
+	SDL_Rect atlasSourceRect;
+	if (const _atlas_region* region = Graphics::READ->atlas->find(texture)) {
+		atlasSourceRect = sourceRect ?
+			SDL_Rect{ region->rect.x + sourceRect->x, region->rect.y + sourceRect->y, sourceRect->w, sourceRect->h } :
+			region->rect;
+
+		texture = region->page;
+		sourceRect = &atlasSourceRect;
+	}
+
+	// Keep operations in order when textures are both drawn and drawn onto
+	for (auto &layer : this->layers) {
+		if (layer.target == texture) { this->flush_Layer(layer); } // <texture> must be complete before it's used
+		if (layer.texture == target && layer.target != target) { this->flush_Layer(layer); } // <target> must not change before it's used
+	}
+
+	// Find layer
+	_sprite_batch_layer* layer = nullptr;
+	for (auto &candidate : this->layers) { if (candidate.target == target) layer = &candidate; }
+
+	if (!layer) {
+		this->layers.push_back({ target, texture });
+		layer = &this->layers.back();
+	}
+
+	if (layer->texture != texture) {
+		this->flush_Layer(*layer);
+		layer->texture = texture;
+	}
+
+	// Source rect => texture coordinates
+	int textureWidth = 0, textureHeight = 0;
+	SDL_QueryTexture(texture, NULL, NULL, &textureWidth, &textureHeight);
+	if (!textureWidth || !textureHeight) { return; } // invalid texture
+
+	const SDL_Rect source = sourceRect ? *sourceRect : SDL_Rect{ 0, 0, textureWidth, textureHeight };
+
+	float u1 = static_cast<float>(source.x) / textureWidth;
+	float u2 = static_cast<float>(source.x + source.w) / textureWidth;
+	float v1 = static_cast<float>(source.y) / textureHeight;
+	float v2 = static_cast<float>(source.y + source.h) / textureHeight;
+
+	if (flip & SDL_FLIP_HORIZONTAL) { std::swap(u1, u2); }
+	if (flip & SDL_FLIP_VERTICAL) { std::swap(v1, v2); }
+
+	// Dest rect => vertex positions
+	SDL_Rect dest;
+	if (destRect) {
+		dest = *destRect;
+	}
+	else if (target) {
+		dest = { 0, 0, 0, 0 };
+		SDL_QueryTexture(target, NULL, NULL, &dest.w, &dest.h);
+	}
+	else {
+		dest = { 0, 0, rendering::RENDERING_WIDTH, rendering::RENDERING_HEIGHT }; // renderer uses logical size
+	}
+
+	const float halfW = dest.w / 2.f;
+	const float halfH = dest.h / 2.f;
+	const float centerX = dest.x + halfW;
+	const float centerY = dest.y + halfH;
+
+	const float corners[4][2] = { { -halfW, -halfH }, { halfW, -halfH }, { halfW, halfH }, { -halfW, halfH } };
+	const float texCoords[4][2] = { { u1, v1 }, { u2, v1 }, { u2, v2 }, { u1, v2 } };
+
+	// Texture mods => vertex color
+	const SDL_Color color = mod;
+
+	const double radians = angle * 3.14159265358979323846 / 180.0; // same direction as 'SDL_RenderCopyEx()' (clockwise)
+	const float cosA = static_cast<float>(std::cos(radians));
+	const float sinA = static_cast<float>(std::sin(radians));
+
+	const int base = static_cast<int>(layer->vertices.size());
+
+	for (int i = 0; i < 4; ++i) {
+		SDL_Vertex vertex;
+		vertex.position.x = centerX + corners[i][0] * cosA - corners[i][1] * sinA;
+		vertex.position.y = centerY + corners[i][0] * sinA + corners[i][1] * cosA;
+		vertex.color = color;
+		vertex.tex_coord.x = texCoords[i][0];
+		vertex.tex_coord.y = texCoords[i][1];
+
+		layer->vertices.push_back(vertex);
+	}
+
+	const int quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	for (const auto index : quadIndices) { layer->indices.push_back(base + index); }
+
+	++this->stats_current.sprites;
+}
+
+void SpriteBatch::flush() {
+	for (auto &layer : this->layers) { this->flush_Layer(layer); }
+}
+void SpriteBatch::flush(SDL_Texture* target) {
+	for (auto &layer : this->layers) { if (layer.target == target) this->flush_Layer(layer); }
+}
+
+void SpriteBatch::endFrame() {
+	this->flush();
+
+	this->stats_last = this->stats_current;
+	this->stats_current = DrawStats();
+}
+
+void SpriteBatch::countCulled() {
+	++this->stats_current.culled_sprites;
+}
+
+void SpriteBatch::setTarget(SDL_Texture* target) {
+	if (this->current_target_known && this->current_target == target) {
+		++this->stats_current.state_changes_skipped;
+		return;
+	}
+
+	SDL_SetRenderTarget(this->renderer, target);
+
+	this->current_target = target;
+	this->current_target_known = true;
+	++this->stats_current.state_changes;
+}
+void SpriteBatch::setTextureMod(SDL_Texture* texture, const SDL_Color &mod) {
+	SDL_Color &current = this->texture_mods.emplace(texture, SDL_Color{ 255, 255, 255, 255 }).first->second;
+
+	if (current.r == mod.r && current.g == mod.g && current.b == mod.b && current.a == mod.a) {
+		++this->stats_current.state_changes_skipped;
+		return;
+	}
+
+	// Pending geometry is unaffected since mods are already encoded into its vertices,
+	// SDL is kept in sync for anything that reads texture mods directly
+	SDL_SetTextureColorMod(texture, mod.r, mod.g, mod.b);
+	SDL_SetTextureAlphaMod(texture, mod.a);
+
+	current = mod;
+	++this->stats_current.state_changes;
+}
+void SpriteBatch::forgetTexture(SDL_Texture* texture) {
+	this->texture_mods.erase(texture);
+}
+
+SDL_Color SpriteBatch::getTextureMod(SDL_Texture* texture) const {
+	const auto mod = this->texture_mods.find(texture);
+	return (mod != this->texture_mods.end()) ? mod->second : SDL_Color{ 255, 255, 255, 255 };
+}
+void SpriteBatch::forgetTextures() {
+	this->texture_mods.clear(); // destroyed textures might have their adresses reused
+}
+
+const DrawStats& SpriteBatch::getStats() const {
+	return this->stats_last;
+}
+
+void SpriteBatch::flush_Layer(_sprite_batch_layer &layer) {
+	if (layer.indices.empty()) { return; }
+
+	this->setTarget(layer.target);
+
+	SDL_RenderGeometry(
+		this->renderer, layer.texture,
+		layer.vertices.data(), static_cast<int>(layer.vertices.size()),
+		layer.indices.data(), static_cast<int>(layer.indices.size())
+	);
+
+	++this->stats_current.draw_calls;
+
+	layer.vertices.clear();
+	layer.indices.clear();
+}
+
+#endif // !HATMAN_HEADLESS
\ No newline at end of file
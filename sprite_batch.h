@@ -0,0 +1,86 @@
+#pragma once
+
+#include <SDL.h> // 'SDL_Vertex', 'SDL_Texture' and related types
+#include <vector> // related type
+#include <unordered_map> // related type
+
+
+
+// # DrawStats #
+// - Rendering statistics of a single frame
+struct DrawStats {
+	int draw_calls = 0; // actual calls to the renderer
+	int sprites = 0; // textured quads submitted (aka number of draw calls without batching)
+	int culled_sprites = 0; // world-space sprites skipped by camera culling, an object made of several sprites counts several times
+	int state_changes = 0; // render target and texture mod changes that reached SDL
+	int state_changes_skipped = 0; // redundant state changes that were avoided
+};
+
+
+
+// # _sprite_batch_layer #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Pending geometry for a single rendering target
+struct _sprite_batch_layer {
+	SDL_Texture* target; // nullptr => renderer itself
+	SDL_Texture* texture;
+
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+};
+
+
+
+// # SpriteBatch #
+// - Collects textured quads and submits them with a single 'SDL_RenderGeometry()' call per batch
+// - Every rendering target (camera, GUI, renderer, captured textures) is a separate layer with its own batch,
+// drawing to one target doesn't break batches of others
+// - Batch of a layer is flushed when its texture changes, so draw order inside a layer is preserved
+// - Texture color/alpha mods are read upon submission and encoded into vertex colors, flip and rotation
+// are encoded into vertex positions, so changing texture mods right after drawing is safe
+// - Layers are flushed automatically when their target is used as a texture, or when a texture that is
+// pending in some batch is about to be drawn onto
+// - Atlas handles are remapped to their atlas pages
+// - Tracks current render target and texture mods, redundant state changes are skipped. Render target
+// and texture mods should only be changed through 'setTarget()' and 'setTextureMod()' so tracked state
+// stays in sync with SDL
+class SpriteBatch {
+public:
+	SpriteBatch(SDL_Renderer* renderer);
+
+	void add(SDL_Texture* target, SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle = 0.0, SDL_RendererFlip flip = SDL_FLIP_NONE);
+		// equivalent of 'SDL_RenderCopyEx()' onto <target>, rotation is done around the center of <destRect>
+		// NULL <sourceRect>/<destRect> mean the whole texture/target
+	void add(SDL_Texture* target, SDL_Texture* texture, const SDL_Rect* sourceRect, const SDL_Rect* destRect, double angle, SDL_RendererFlip flip, const SDL_Color &mod);
+		// same as above, but uses given texture mods instead of current ones
+
+	void flush(); // submits all pending geometry
+	void flush(SDL_Texture* target); // submits pending geometry of a single target
+
+	void endFrame(); // flushes everything and saves stats of the frame
+
+	void countCulled(); // records a sprite that was culled before reaching the batch
+
+	void setTarget(SDL_Texture* target); // 'SDL_SetRenderTarget()' that skips redundant calls, NULL => renderer
+	void setTextureMod(SDL_Texture* texture, const SDL_Color &mod); // sets color and alpha mod, skips redundant calls
+	SDL_Color getTextureMod(SDL_Texture* texture) const; // returns tracked color and alpha mod
+	void forgetTextures(); // drops tracked texture mods, should be called when textures are destroyed
+	void forgetTexture(SDL_Texture* texture); // same as above for a single texture
+
+	const DrawStats& getStats() const; // returns stats of the last finished frame
+
+private:
+	void flush_Layer(_sprite_batch_layer &layer);
+
+	SDL_Renderer* renderer;
+
+	std::vector<_sprite_batch_layer> layers; // there are only a few targets, so linear search is fine
+
+	SDL_Texture* current_target = nullptr;
+	bool current_target_known = false; // target is unknown until the first 'setTarget()'
+
+	std::unordered_map<SDL_Texture*, SDL_Color> texture_mods; // textures without an entry have no mods
+
+	DrawStats stats_current;
+	DrawStats stats_last;
+};
@@ -0,0 +1,129 @@
+// Left out of headless build, see 'graphics_headless.cpp'
+#ifndef HATMAN_HEADLESS
+
+#include "texture_atlas.h"
+
+#include <algorithm> // 'std::sort()'
+#include <future> // 'std::future' type (parallel decoding)
+
+#include "image_decoder.h" // decoding of images
+
+
+
+// # TextureAtlas #
+TextureAtlas::TextureAtlas(SDL_Renderer* renderer) :
+	renderer(renderer)
+{}
+
+TextureAtlas::~TextureAtlas() {
+	this->clear();
+}
+
+std::unordered_map<std::string, SDL_Texture*> TextureAtlas::build(const std::vector<std::string> &filePaths) {
+	std::unordered_map<std::string, SDL_Texture*> handles;
+
+	// Load images
+	struct Image {
+		const std::string* path;
+		SDL_Surface* surface;
+	};
+
+	std::vector<const std::string*> packedPaths;
+	std::vector<std::future<SDL_Surface*>> decodes; // all images are decoded in parallel
+	for (const auto &path : filePaths) {
+		Vector2 size;
+		if (ImageDecoder::readSize(path, size) && (size.x > MAX_IMAGE_SIZE || size.y > MAX_IMAGE_SIZE)) { continue; } // don't decode what won't be packed
+
+		packedPaths.push_back(&path);
+		decodes.push_back(ImageDecoder::decodeAsync(path));
+	}
+
+	std::vector<Image> images;
+	for (size_t i = 0; i < packedPaths.size(); ++i) {
+		const std::string &path = *packedPaths[i];
+
+		SDL_Surface* surface = decodes[i].get();
+		if (!surface) { continue; }
+
+		if (surface->w > MAX_IMAGE_SIZE || surface->h > MAX_IMAGE_SIZE) {
+			SDL_FreeSurface(surface);
+			continue;
+		}
+
+		SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE); // copy pixels as they are, including alpha
+		images.push_back({ &path, surface });
+	}
+
+	// Shelf packing, tallest images first
+	std::sort(images.begin(), images.end(), [](const Image &a, const Image &b) {
+		return (a.surface->h != b.surface->h) ? (a.surface->h > b.surface->h) : (a.surface->w > b.surface->w);
+	});
+
+	SDL_Surface* pageSurface = nullptr;
+	Vector2 cursor; // top-left corner of the next image
+	int shelfHeight = 0;
+	std::vector<std::pair<SDL_Texture*, SDL_Rect>> pagePlacements; // handles waiting for their page texture
+
+	const auto finishPage = [&]() {
+		if (!pageSurface) { return; }
+
+		SDL_Texture* page = SDL_CreateTextureFromSurface(this->renderer, pageSurface);
+		SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+		SDL_FreeSurface(pageSurface);
+		pageSurface = nullptr;
+
+		this->pages.push_back(page);
+		for (const auto &placement : pagePlacements) { this->regions[placement.first] = { page, placement.second }; }
+		pagePlacements.clear();
+	};
+
+	for (const auto &image : images) {
+		const int w = image.surface->w + PADDING;
+		const int h = image.surface->h + PADDING;
+
+		if (pageSurface && cursor.x + w > PAGE_SIZE) { // next shelf
+			cursor = Vector2(0, cursor.y + shelfHeight);
+			shelfHeight = 0;
+		}
+		if (pageSurface && cursor.y + h > PAGE_SIZE) { finishPage(); } // next page
+		if (!pageSurface) {
+			pageSurface = SDL_CreateRGBSurfaceWithFormat(0, PAGE_SIZE, PAGE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888); // zeroed => transparent
+			cursor = Vector2(0, 0);
+			shelfHeight = 0;
+		}
+
+		SDL_Rect rect = { cursor.x, cursor.y, image.surface->w, image.surface->h };
+		SDL_BlitSurface(image.surface, NULL, pageSurface, &rect);
+		SDL_FreeSurface(image.surface);
+
+		SDL_Texture* handle = SDL_CreateTexture(this->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+		pagePlacements.push_back({ handle, rect });
+		handles[*image.path] = handle;
+
+		cursor.x += w;
+		shelfHeight = std::max(shelfHeight, h);
+	}
+
+	finishPage();
+
+	return handles;
+}
+
+void TextureAtlas::clear() {
+	for (auto &region : this->regions) { SDL_DestroyTexture(region.first); }
+	for (auto &page : this->pages) { SDL_DestroyTexture(page); }
+
+	this->regions.clear();
+	this->pages.clear();
+}
+
+const _atlas_region* TextureAtlas::find(SDL_Texture* handle) const {
+	const auto it = this->regions.find(handle);
+	return (it != this->regions.end()) ? &it->second : nullptr;
+}
+
+size_t TextureAtlas::pageCount() const {
+	return this->pages.size();
+}
+
+#endif // !HATMAN_HEADLESS
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <SDL.h> // 'SDL_Texture', 'SDL_Rect' and related types
+#include <string> // related type
+#include <vector> // related type
+#include <unordered_map> // related type
+
+#include "geometry_utils.h" // geometry types
+
+
+
+// # _atlas_region #
+// - NOT INTENDED FOR EXTERNAL USE!
+// - Place of a single image inside of an atlas page
+struct _atlas_region {
+	SDL_Texture* page;
+	SDL_Rect rect;
+};
+
+
+
+// # TextureAtlas #
+// - Part of 'Graphics' module
+// - Packs small images into a few large textures (pages), so sprites of different entities, items,
+// skills and GUI elements can share a single batch
+// - Each packed image gets its own 'handle' texture that is used everywhere in place of the real one,
+// 'SpriteBatch' remaps handles to their pages and source rects transparently
+// - Handles are 1x1 textures, use 'Graphics::getTextureSize()' instead of 'SDL_QueryTexture()'
+// - Images that are too large are not packed
+class TextureAtlas {
+public:
+	TextureAtlas(SDL_Renderer* renderer);
+
+	~TextureAtlas(); // frees pages and handles
+
+	std::unordered_map<std::string, SDL_Texture*> build(const std::vector<std::string> &filePaths);
+		// loads and packs images, returns handles of packed ones by file path
+		// images that weren't packed should be loaded as regular textures
+	void clear(); // frees pages and handles
+
+	const _atlas_region* find(SDL_Texture* handle) const; // returns nullptr if texture is not a handle
+
+	size_t pageCount() const;
+
+	static const int PAGE_SIZE = 1024;
+	static const int MAX_IMAGE_SIZE = 512; // larger images are not worth packing
+	static const int PADDING = 1; // prevents bleeding of neighbours
+
+private:
+	SDL_Renderer* renderer;
+
+	std::vector<SDL_Texture*> pages; // requires destruction!
+	std::unordered_map<SDL_Texture*, _atlas_region> regions; // keys are handles, require destruction!
+};
@@ -0,0 +1,47 @@
+#include "timer.h"
+
+#include <algorithm> // 'std::min()'
+
+
+
+// # Timer #
+void Timer::start(Milliseconds duration) {
+	this->running = true;
+	this->start_time = TimerController::READ->time();
+	this->timer_duration = duration;
+}
+
+void Timer::stop() {
+	this->running = false;
+}
+
+bool Timer::finished() const {
+	return !this->running || this->elapsed() >= this->timer_duration;
+}
+
+Milliseconds Timer::elapsed() const {
+	return this->running ? std::min(TimerController::READ->time() - this->start_time, this->timer_duration) : this->timer_duration;
+}
+
+Milliseconds Timer::duration() const {
+	return this->timer_duration;
+}
+
+
+
+// # TimerController #
+thread_local const TimerController* TimerController::READ;
+thread_local TimerController* TimerController::ACCESS;
+
+TimerController::TimerController() {
+	this->READ = this;
+	this->ACCESS = this;
+}
+
+void TimerController::update(Milliseconds elapsedTime) {
+	this->time_elapsed += elapsedTime;
+}
+
+Milliseconds TimerController::time() const {
+	return this->time_elapsed;
+}
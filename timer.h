@@ -0,0 +1,52 @@
+#pragma once
+
+
+
+using Milliseconds = double; // time in ms, used everywhere time is measured
+
+constexpr double per_second(Milliseconds time) { return time / 1000.; } // converts to seconds, used by 'per second' rates
+
+
+
+// # Timer #
+// - Counts given time on the 'TimerController' of its instance
+// - Doesn't register anywhere, it only remembers when it ends, so timers can be copied and
+// checked from parallel entity updates freely
+// - Timer that was never started (or was stopped) counts as finished
+class Timer {
+public:
+	Timer() = default;
+
+	void start(Milliseconds duration); // (re)starts the timer
+	void stop(); // timer becomes finished
+
+	bool finished() const;
+	Milliseconds elapsed() const; // time since start, capped at duration
+	Milliseconds duration() const; // duration of the last start
+
+private:
+	bool running = false;
+	Milliseconds start_time = 0; // 'TimerController' time when timer was started
+	Milliseconds timer_duration = 0;
+};
+
+
+
+// # TimerController #
+// - Can be accessed wherever #include'ed through static 'READ' and 'ACCESS' fields (per instance, see 'InstanceContext')
+// - Holds game time of the instance, all timers are measured against it
+// - Advanced once per simulation step, so timers are paused together with the game
+class TimerController {
+public:
+	TimerController();
+
+	static thread_local const TimerController* READ; // used for aka 'global' access
+	static thread_local TimerController* ACCESS;
+
+	void update(Milliseconds elapsedTime); // advances time of all timers
+
+	Milliseconds time() const; // total time advanced since creation
+
+private:
+	Milliseconds time_elapsed = 0;
+};